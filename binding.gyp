@@ -1,14 +1,28 @@
 {
+  "variables": {
+    # Scanner instrumentation counters (common/scanner_stats.h), e.g. `npm_config_jass_scanner_stats=1 npm install`
+    "jass_scanner_stats%": "<!(node -p \"process.env.npm_config_jass_scanner_stats || 0\")",
+    # Optimized builds (README, "Optimized builds"): `npm_config_jass_optimize=1` adds -O3 and LTO,
+    # `npm_config_jass_pgo=generate|use` builds with instrumentation or with the profiles in `jass_pgo_dir`
+    "jass_optimize%": "<!(node -p \"process.env.npm_config_jass_optimize || 0\")",
+    "jass_pgo%": "<!(node -p \"process.env.npm_config_jass_pgo || ''\")",
+    "jass_pgo_dir%": "<!(node -p \"require('path').resolve(process.env.npm_config_jass_pgo_dir || 'build-pgo')\")",
+    # parseMany, exportFlat, outline, decodeLiterals, loadSymbols and checkIds link the tree-sitter runtime vendored by the `tree-sitter` package, when installed.
+    # That is a private copy of lib.c, not node-tree-sitter's own runtime: the allocator hooks of parseMany (arena, countAllocations) only configure this copy.
+    "tree_sitter_runtime%": "<!(node -p \"try { require('path').join(require('path').dirname(require.resolve('tree-sitter/package.json')), 'vendor', 'tree-sitter', 'lib') } catch (_) { '' }\")",
+  },
   "targets": [{
     "target_name": "tree_sitter_jass_binding",
     "dependencies": [
       "<!(node -p \"require('node-addon-api').targets\"):node_addon_api_except",
     ],
     "include_dirs": [
-      "src"
+      "src",
+      "common"
     ],
     "sources": [
       "bindings/node/binding.cc",
+      "bindings/node/scanner_stats.cc",
       "src/parser.c",
       "src/scanner.c"
     ],
@@ -22,6 +36,71 @@
           "/std:c11",
         ],
       }],
+      ["jass_optimize==1 and OS!='win'", {
+        "cflags_c": ["-O3", "-flto"],
+        "cflags_cc": ["-flto"],
+        "ldflags": ["-flto"],
+        "xcode_settings": {
+          "GCC_OPTIMIZATION_LEVEL": "3",
+          "LLVM_LTO": "YES",
+        },
+      }],
+      ["jass_optimize==1 and OS=='win'", {
+        "msvs_settings": {
+          "VCCLCompilerTool": {
+            "Optimization": 2,
+            "WholeProgramOptimization": "true",
+          },
+          "VCLinkerTool": {
+            "LinkTimeCodeGeneration": 1,
+          },
+        },
+      }],
+      # GCC on Linux; clang on macOS reads <(jass_pgo_dir)/default.profdata
+      ["jass_pgo=='generate' and OS!='win'", {
+        "cflags_c": ["-fprofile-generate=<(jass_pgo_dir)", "-fprofile-update=atomic"],
+        "ldflags": ["-fprofile-generate=<(jass_pgo_dir)"],
+        "xcode_settings": {
+          "OTHER_CFLAGS": ["-fprofile-generate=<(jass_pgo_dir)"],
+          "OTHER_LDFLAGS": ["-fprofile-generate=<(jass_pgo_dir)"],
+        },
+      }],
+      ["jass_pgo=='use' and OS=='linux'", {
+        "cflags_c": ["-fprofile-use=<(jass_pgo_dir)", "-fprofile-correction", "-Wno-missing-profile"],
+      }],
+      ["jass_pgo=='use' and OS=='mac'", {
+        "xcode_settings": {
+          "OTHER_CFLAGS": ["-fprofile-use=<(jass_pgo_dir)", "-Wno-profile-instr-unprofiled"],
+        },
+      }],
+      ["jass_scanner_stats==1", {
+        "defines": ["JASS_SCANNER_STATS"],
+      }],
+      ["tree_sitter_runtime!=''", {
+        "defines": ["JASS_RUNTIME", "_POSIX_C_SOURCE=200112L", "_DEFAULT_SOURCE"],
+        "include_dirs": [
+          "<(tree_sitter_runtime)/include",
+          "<(tree_sitter_runtime)/src",
+          "bindings/c"
+        ],
+        "sources": [
+          "bindings/c/alloc.c",
+          "bindings/c/literals.c",
+          "bindings/c/mapped.c",
+          "bindings/c/outline.c",
+          "bindings/c/prescan.c",
+          "bindings/c/split.c",
+          "bindings/c/symtab.c",
+          "bindings/node/export_flat.cc",
+          "bindings/node/ids.cc",
+          "bindings/node/literals.cc",
+          "bindings/node/outline.cc",
+          "bindings/node/parse_many.cc",
+          "bindings/node/parse_split.cc",
+          "bindings/node/symbols.cc",
+          "<(tree_sitter_runtime)/src/lib.c"
+        ],
+      }],
     ],
   }]
 }
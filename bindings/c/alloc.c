@@ -0,0 +1,302 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "alloc.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+// From tree_sitter/api.h; declared here so this file builds without the
+// runtime headers. The symbol itself comes from the linked runtime.
+void ts_set_allocator(void *(*new_malloc)(size_t size),
+                      void *(*new_calloc)(size_t count, size_t size),
+                      void *(*new_realloc)(void *ptr, size_t size),
+                      void (*new_free)(void *ptr));
+
+#define ALIGNMENT 16
+#define MAX_CHUNK_SIZE ((size_t)64 << 20)
+
+typedef struct Chunk {
+    struct Chunk *next;
+    size_t size;
+    size_t used;
+    size_t padding;  // keeps data 16-byte aligned
+    unsigned char data[];
+} Chunk;
+
+// Precedes every arena block, so realloc knows how much to copy
+typedef struct {
+    size_t size;
+    size_t padding;
+} BlockHeader;
+
+struct JassArena {
+    Chunk *chunks;  // newest (and largest) first
+    size_t next_chunk_size;
+    size_t used;
+};
+
+static THREAD_LOCAL JassArena *current_arena;
+static THREAD_LOCAL JassAllocStats *current_stats;
+
+// --- Registry of live chunks ---
+//
+// Every chunk of every arena, sorted by address. free and realloc of a
+// block the current arena doesn't own look it up with a range test, so an
+// arena block released after its scope ended (which breaks the contract in
+// alloc.h) is recognized without reading memory outside the block, and
+// never reaches the system allocator. While no chunk exists the counter
+// keeps the hooks off the lock.
+
+#if defined(_WIN32)
+static SRWLOCK registry_lock = SRWLOCK_INIT;
+#define READ_LOCK() AcquireSRWLockShared(&registry_lock)
+#define READ_UNLOCK() ReleaseSRWLockShared(&registry_lock)
+#define WRITE_LOCK() AcquireSRWLockExclusive(&registry_lock)
+#define WRITE_UNLOCK() ReleaseSRWLockExclusive(&registry_lock)
+static volatile LONG live_chunks;
+#define LIVE_CHUNKS() (live_chunks != 0)
+#define SET_LIVE_CHUNKS(n) InterlockedExchange(&live_chunks, (LONG)(n))
+#else
+static pthread_rwlock_t registry_lock = PTHREAD_RWLOCK_INITIALIZER;
+#define READ_LOCK() pthread_rwlock_rdlock(&registry_lock)
+#define READ_UNLOCK() pthread_rwlock_unlock(&registry_lock)
+#define WRITE_LOCK() pthread_rwlock_wrlock(&registry_lock)
+#define WRITE_UNLOCK() pthread_rwlock_unlock(&registry_lock)
+static atomic_size_t live_chunks;
+#define LIVE_CHUNKS() (atomic_load_explicit(&live_chunks, memory_order_relaxed) != 0)
+#define SET_LIVE_CHUNKS(n) atomic_store_explicit(&live_chunks, (n), memory_order_relaxed)
+#endif
+
+static const Chunk **registry;
+static size_t registry_count;
+static size_t registry_capacity;
+
+// First registry slot whose chunk starts above ptr; call with the lock held
+static size_t registry_upper_bound(const void *ptr) {
+    size_t lo = 0, hi = registry_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((uintptr_t)registry[mid]->data <= (uintptr_t)ptr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static bool registry_add(const Chunk *chunk) {
+    WRITE_LOCK();
+    bool added = true;
+    if (registry_count == registry_capacity) {
+        size_t capacity = registry_capacity ? registry_capacity * 2 : 64;
+        const Chunk **grown = realloc((void *)registry, capacity * sizeof *registry);
+        if (grown) {
+            registry = grown;
+            registry_capacity = capacity;
+        } else {
+            added = false;
+        }
+    }
+    if (added) {
+        size_t slot = registry_upper_bound(chunk->data);
+        memmove(registry + slot + 1, registry + slot, (registry_count - slot) * sizeof *registry);
+        registry[slot] = chunk;
+        SET_LIVE_CHUNKS(++registry_count);
+    }
+    WRITE_UNLOCK();
+    return added;
+}
+
+static void registry_remove(const Chunk *chunk) {
+    WRITE_LOCK();
+    size_t slot = registry_upper_bound(chunk->data);
+    if (slot > 0 && registry[slot - 1] == chunk) {
+        memmove(registry + slot - 1, registry + slot, (registry_count - slot) * sizeof *registry);
+        SET_LIVE_CHUNKS(--registry_count);
+    }
+    WRITE_UNLOCK();
+}
+
+// Whether ptr lies in a chunk of any live arena
+static bool registry_owns(const void *ptr) {
+    if (!LIVE_CHUNKS()) return false;
+    READ_LOCK();
+    size_t slot = registry_upper_bound(ptr);
+    const Chunk *chunk = slot > 0 ? registry[slot - 1] : NULL;
+    bool owned = chunk && (uintptr_t)ptr < (uintptr_t)(chunk->data + chunk->size);
+    READ_UNLOCK();
+    return owned;
+}
+
+static size_t align_up(size_t size) { return (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1); }
+
+static Chunk *chunk_new(size_t size) {
+    Chunk *chunk = malloc(sizeof(Chunk) + size);
+    if (!chunk) return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    if (!registry_add(chunk)) {
+        free(chunk);
+        return NULL;
+    }
+    return chunk;
+}
+
+static void chunk_free(Chunk *chunk) {
+    registry_remove(chunk);
+    free(chunk);
+}
+
+static bool arena_owns(const JassArena *arena, const void *ptr) {
+    const unsigned char *p = ptr;
+    for (const Chunk *chunk = arena->chunks; chunk; chunk = chunk->next) {
+        if (p >= chunk->data && p < chunk->data + chunk->size) return true;
+    }
+    return false;
+}
+
+static void *arena_alloc(JassArena *arena, size_t size) {
+    size_t needed = sizeof(BlockHeader) + align_up(size ? size : 1);
+    Chunk *chunk = arena->chunks;
+    if (!chunk || chunk->size - chunk->used < needed) {
+        size_t chunk_size = arena->next_chunk_size;
+        while (chunk_size < needed) chunk_size *= 2;
+        chunk = chunk_new(chunk_size);
+        if (!chunk) return NULL;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        if (arena->next_chunk_size < MAX_CHUNK_SIZE) arena->next_chunk_size *= 2;
+    }
+    BlockHeader *header = (BlockHeader *)(chunk->data + chunk->used);
+    header->size = size;
+    chunk->used += needed;
+    arena->used += needed;
+    return header + 1;
+}
+
+static void count(size_t bytes) {
+    if (current_stats) {
+        current_stats->calls++;
+        current_stats->bytes += bytes;
+    }
+}
+
+static void *hook_malloc(size_t size) {
+    count(size);
+    return current_arena ? arena_alloc(current_arena, size) : malloc(size);
+}
+
+static void *hook_calloc(size_t n, size_t size) {
+    if (size && n > SIZE_MAX / size) return NULL;
+    count(n * size);
+    if (!current_arena) return calloc(n, size);
+    // Chunks are reused after a reset, so arena memory is not zeroed
+    void *ptr = arena_alloc(current_arena, n * size);
+    if (ptr) memset(ptr, 0, n * size);
+    return ptr;
+}
+
+static void *hook_realloc(void *ptr, size_t size) {
+    count(size);
+    if (ptr && current_arena && arena_owns(current_arena, ptr)) {
+        size_t old_size = ((BlockHeader *)ptr - 1)->size;
+        if (size <= old_size) {
+            ((BlockHeader *)ptr - 1)->size = size;
+            return ptr;
+        }
+        void *moved = arena_alloc(current_arena, size);
+        if (moved) memcpy(moved, ptr, old_size);
+        return moved;
+    }
+    // An arena block outside its scope breaks the contract in alloc.h, but
+    // must not reach the system allocator: copy it out and leave it to the
+    // arena's reset
+    if (ptr && registry_owns(ptr)) {
+        size_t old_size = ((BlockHeader *)ptr - 1)->size;
+        void *moved = current_arena ? arena_alloc(current_arena, size) : malloc(size);
+        if (moved) memcpy(moved, ptr, old_size < size ? old_size : size);
+        return moved;
+    }
+    // System blocks stay system blocks, even inside an arena scope
+    if (!ptr && current_arena) return arena_alloc(current_arena, size);
+    return realloc(ptr, size);
+}
+
+static void hook_free(void *ptr) {
+    if (current_stats) current_stats->frees++;
+    if (!ptr) return;
+    if (current_arena && arena_owns(current_arena, ptr)) return;
+    // Arena blocks are released by the arena, also after their scope ended
+    if (registry_owns(ptr)) return;
+    free(ptr);
+}
+
+void jass_alloc_install(void) {
+    // ts_set_allocator only stores four pointers; repeating it is harmless
+    ts_set_allocator(hook_malloc, hook_calloc, hook_realloc, hook_free);
+}
+
+JassArena *jass_arena_new(size_t chunk_size) {
+    JassArena *arena = malloc(sizeof(JassArena));
+    if (!arena) return NULL;
+    arena->chunks = NULL;
+    arena->next_chunk_size = chunk_size < 4096 ? 4096 : align_up(chunk_size);
+    arena->used = 0;
+    return arena;
+}
+
+void jass_arena_delete(JassArena *arena) {
+    if (!arena) return;
+    for (Chunk *chunk = arena->chunks, *next; chunk; chunk = next) {
+        next = chunk->next;
+        chunk_free(chunk);
+    }
+    free(arena);
+}
+
+JassArena *jass_arena_enter(JassArena *arena) {
+    JassArena *previous = current_arena;
+    current_arena = arena;
+    return previous;
+}
+
+void jass_arena_leave(JassArena *previous) { current_arena = previous; }
+
+void jass_arena_reset(JassArena *arena) {
+    Chunk *keep = arena->chunks;
+    if (!keep) return;
+    for (Chunk *chunk = keep->next, *next; chunk; chunk = next) {
+        next = chunk->next;
+        chunk_free(chunk);
+    }
+    keep->next = NULL;
+    keep->used = 0;
+    arena->used = 0;
+}
+
+size_t jass_arena_used(const JassArena *arena) { return arena->used; }
+
+JassAllocStats *jass_alloc_count(JassAllocStats *stats) {
+    JassAllocStats *previous = current_stats;
+    current_stats = stats;
+    return previous;
+}
@@ -0,0 +1,66 @@
+// Allocator hooks for the tree-sitter runtime: per-thread bump arenas and
+// allocation counting.
+//
+// jass_alloc_install() points the runtime allocator (ts_set_allocator) at
+// hooks that route each call by thread-local state:
+//
+// - While an arena is entered on a thread, malloc/calloc/realloc on that
+//   thread bump-allocate from it, and frees of its blocks are no-ops.
+//   Everything is released at once by jass_arena_reset().
+// - Otherwise the system allocator is used, so the hooks are safe to
+//   install after parsers already exist.
+// - A counter set with jass_alloc_count() counts calls and requested bytes
+//   in either mode.
+//
+// Contract: whatever is allocated while an arena is entered (parsers, trees,
+// cursors, query cursors) must be deleted on the same thread before the
+// arena is left. The bindings satisfy this by creating the parser inside
+// the scope and dropping parser and tree before leaving it. An arena block
+// freed or reallocated after its scope ended is still recognized, by a range
+// test against a registry of every arena's live chunks, and never reaches
+// the system allocator.
+
+#ifndef TREE_SITTER_JASS_ALLOC_H_
+#define TREE_SITTER_JASS_ALLOC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct JassArena JassArena;
+
+typedef struct {
+    uint64_t calls;  // malloc, calloc and realloc calls
+    uint64_t frees;  // free calls, including no-op arena frees
+    uint64_t bytes;  // bytes requested by those calls
+} JassAllocStats;
+
+// Installs the hooks into the tree-sitter runtime; idempotent.
+void jass_alloc_install(void);
+
+// chunk_size is the first chunk's size; later chunks double, up to 64 MiB.
+JassArena *jass_arena_new(size_t chunk_size);
+void jass_arena_delete(JassArena *arena);
+
+// Makes `arena` current on this thread and returns the previous one, which
+// must be passed back to jass_arena_leave().
+JassArena *jass_arena_enter(JassArena *arena);
+void jass_arena_leave(JassArena *previous);
+
+// Releases every block at once; keeps the largest chunk for reuse.
+void jass_arena_reset(JassArena *arena);
+// Bytes handed out since the last reset, including block headers.
+size_t jass_arena_used(const JassArena *arena);
+
+// Counts allocations of this thread into `stats` (NULL stops counting);
+// returns the previous counter.
+JassAllocStats *jass_alloc_count(JassAllocStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_ALLOC_H_
@@ -0,0 +1,346 @@
+#include "literals.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int digit_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 16;
+}
+
+// `c` is the lowercase letter `lower` in either case
+static bool is_letter(char c, char lower) { return c == lower || c == lower - 'a' + 'A'; }
+
+uint8_t jass_decode_number(const char *text, size_t length, uint32_t *value) {
+    uint8_t flags = 0;
+    *value = 0;
+
+    // Suffix: exactly one of l, u or ul, in either case; lu, ll and uu are
+    // not suffixes, and their leftover letter fails as a digit below
+    if (length > 1 && is_letter(text[length - 1], 'l') && is_letter(text[length - 2], 'u')) {
+        flags |= JASS_LITERAL_UNSIGNED | JASS_LITERAL_LONG;
+        length -= 2;
+    } else if (length > 0 && is_letter(text[length - 1], 'l')) {
+        flags |= JASS_LITERAL_LONG;
+        length--;
+    } else if (length > 0 && is_letter(text[length - 1], 'u')) {
+        flags |= JASS_LITERAL_UNSIGNED;
+        length--;
+    }
+
+    // Prefix: $ and 0x are hex, 0b binary
+    size_t i = 0;
+    unsigned base = 10;
+    if (length > 0 && text[0] == '$') {
+        base = 16;
+        i = 1;
+    } else if (length > 1 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        i = 2;
+    } else if (length > 1 && text[0] == '0' && (text[1] == 'b' || text[1] == 'B')) {
+        base = 2;
+        i = 2;
+    }
+
+    // Separators only ever stand between two digits
+    uint64_t result = 0;
+    bool digits = false, separator = false;
+    for (; i < length; i++) {
+        if (text[i] == '_') {
+            if (!digits || separator) return (uint8_t)(flags | JASS_LITERAL_INVALID);
+            separator = true;
+            continue;
+        }
+        unsigned digit = (unsigned)digit_value(text[i]);
+        if (digit >= base) return (uint8_t)(flags | JASS_LITERAL_INVALID);
+        result = result * base + digit;
+        if (result > UINT32_MAX) {
+            flags |= JASS_LITERAL_OVERFLOW;
+            result &= UINT32_MAX;
+        }
+        digits = true;
+        separator = false;
+    }
+    if (!digits || separator) return (uint8_t)(flags | JASS_LITERAL_INVALID);
+    *value = (uint32_t)result;
+    return flags;
+}
+
+// --- Decimal to float ---
+//
+// strtof() follows the process's LC_NUMERIC locale, so under a locale with
+// a `,` decimal separator it would reject every `1.5`. Floats are converted
+// here instead, exactly: the significant digits are a big integer D, the
+// value is D * 10^exp10, and D is divided out to 26 or 27 bits and rounded
+// once to the nearest float, ties to even, subnormals included.
+
+#define BIG_LIMBS 32    // 1024 bits: 201 digits over 10^247, shifted by 27
+#define MAX_DIGITS 200  // beyond this many, digits only decide a sticky bit
+
+typedef struct {
+    uint32_t limb[BIG_LIMBS];  // little-endian
+    size_t size;               // limbs in use; the top one is nonzero
+} Big;
+
+static void big_set(Big *big, uint32_t value) {
+    big->limb[0] = value;
+    big->size = value ? 1 : 0;
+}
+
+static void big_mul_add(Big *big, uint32_t factor, uint32_t addend) {
+    uint64_t carry = addend;
+    for (size_t i = 0; i < big->size; i++) {
+        uint64_t product = (uint64_t)big->limb[i] * factor + carry;
+        big->limb[i] = (uint32_t)product;
+        carry = product >> 32;
+    }
+    if (carry) big->limb[big->size++] = (uint32_t)carry;
+}
+
+static size_t big_bits(const Big *big) {
+    if (big->size == 0) return 0;
+    size_t bits = big->size * 32;
+    for (uint32_t top = big->limb[big->size - 1]; !(top & 0x80000000u); top <<= 1) bits--;
+    return bits;
+}
+
+static void big_shift_left(Big *out, const Big *big, size_t bits) {
+    size_t limbs = bits / 32;
+    unsigned shift = bits % 32;
+    if (big->size == 0) {
+        out->size = 0;
+        return;
+    }
+    out->limb[big->size + limbs] = 0;
+    for (size_t i = big->size; i-- > 0;) {
+        uint64_t wide = (uint64_t)big->limb[i] << shift;
+        out->limb[i + limbs + 1] |= (uint32_t)(wide >> 32);
+        out->limb[i + limbs] = (uint32_t)wide;
+    }
+    for (size_t i = 0; i < limbs; i++) out->limb[i] = 0;
+    out->size = big->size + limbs + 1;
+    while (out->size > 0 && out->limb[out->size - 1] == 0) out->size--;
+}
+
+static int big_compare(const Big *a, const Big *b) {
+    if (a->size != b->size) return a->size < b->size ? -1 : 1;
+    for (size_t i = a->size; i-- > 0;) {
+        if (a->limb[i] != b->limb[i]) return a->limb[i] < b->limb[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// a -= b, for a >= b
+static void big_subtract(Big *a, const Big *b) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < a->size; i++) {
+        uint64_t difference = (uint64_t)a->limb[i] - (i < b->size ? b->limb[i] : 0) - borrow;
+        a->limb[i] = (uint32_t)difference;
+        borrow = difference >> 63;
+    }
+    while (a->size > 0 && a->limb[a->size - 1] == 0) a->size--;
+}
+
+// The float nearest to n * 10^exp10, for a nonzero n whose value is known
+// to lie in [1e-46, 1e39); consumes n
+static float decimal_to_float(Big *n, int exp10) {
+    Big d;
+    big_set(&d, 1);
+    for (; exp10 > 0; exp10--) big_mul_add(n, 10, 0);
+    for (; exp10 < 0; exp10++) big_mul_add(&d, 10, 0);
+
+    // n / d = (q + fraction) * 2^scale with q of 26 or 27 bits: scale the
+    // smaller side up until n has 26 bits more than d
+    int scale = (int)big_bits(n) - (int)big_bits(&d) - 26;
+    Big shifted;
+    if (scale < 0) {
+        big_shift_left(&shifted, n, (size_t)-scale);
+        *n = shifted;
+    } else {
+        big_shift_left(&shifted, &d, (size_t)scale);
+        d = shifted;
+    }
+    uint32_t q = 0;
+    for (int bit = 26; bit >= 0; bit--) {
+        big_shift_left(&shifted, &d, (size_t)bit);
+        if (big_compare(n, &shifted) >= 0) {
+            big_subtract(n, &shifted);
+            q |= (uint32_t)1 << bit;
+        }
+    }
+    bool inexact = n->size != 0;
+
+    // Keep 24 bits, or fewer down at the subnormal exponent 2^-149
+    int top = 31;
+    while (!(q >> top)) top--;
+    int lsb = top + scale - 23;
+    if (lsb < -149) lsb = -149;
+    int dropped = lsb - scale;  // at least 2, and under 40 within the range
+    if (dropped > 40) return 0.0f;
+    uint64_t mantissa = (uint64_t)q >> dropped;
+    uint64_t rest = q & (((uint64_t)1 << dropped) - 1), half = (uint64_t)1 << (dropped - 1);
+    if (rest > half || (rest == half && (inexact || (mantissa & 1)))) mantissa++;
+    return ldexpf((float)mantissa, lsb);
+}
+
+uint8_t jass_decode_float(const char *text, size_t length, uint32_t *value) {
+    *value = 0;
+    if (length > 0 && is_letter(text[length - 1], 'f')) length--;
+    if (length == 0 || !(text[0] == '.' || (text[0] >= '0' && text[0] <= '9'))) {
+        return JASS_LITERAL_INVALID;
+    }
+
+    // Digits with at most one `.`, then an optional exponent; `_` may stand
+    // anywhere in the digits
+    size_t i = 0, digits = 0, fraction = 0;
+    bool point = false;
+    for (; i < length; i++) {
+        char c = text[i];
+        if (c == '_') continue;
+        if (c == '.' && !point) {
+            point = true;
+        } else if (c >= '0' && c <= '9') {
+            digits++;
+            if (point) fraction++;
+        } else {
+            break;
+        }
+    }
+    size_t mantissa_end = i;
+    long exponent = 0;
+    if (i < length && is_letter(text[i], 'e')) {
+        i++;
+        bool negative = i < length && text[i] == '-';
+        if (i < length && (text[i] == '-' || text[i] == '+')) i++;
+        size_t start = i;
+        // Any exponent past the float range saturates the same way
+        for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+            if (exponent < 100000) exponent = exponent * 10 + (text[i] - '0');
+        }
+        if (i == start) return JASS_LITERAL_INVALID;
+        if (negative) exponent = -exponent;
+    }
+    if (digits == 0 || i != length) return JASS_LITERAL_INVALID;
+
+    // The significant digits run from the first to the last nonzero digit
+    size_t first = SIZE_MAX, last = 0, index = 0;
+    for (i = 0; i < mantissa_end; i++) {
+        if (text[i] < '0' || text[i] > '9') continue;
+        if (text[i] != '0') {
+            if (first == SIZE_MAX) first = index;
+            last = index;
+        }
+        index++;
+    }
+    float real = 0.0f;
+    uint8_t flags = 0;
+    if (first != SIZE_MAX) {
+        size_t count = last - first + 1;
+        size_t kept = count < MAX_DIGITS ? count : MAX_DIGITS;
+        Big n;
+        big_set(&n, 0);
+        index = 0;
+        for (i = 0; i < mantissa_end && index < first + kept; i++) {
+            if (text[i] < '0' || text[i] > '9') continue;
+            if (index++ < first) continue;
+            if (n.size == 0) {
+                big_set(&n, (uint32_t)(text[i] - '0'));
+            } else {
+                big_mul_add(&n, 10, (uint32_t)(text[i] - '0'));
+            }
+        }
+        // The value is n * 10^exp10. Digits dropped past MAX_DIGITS end in
+        // a nonzero one, so a final 1 stands in for them.
+        long exp10 = exponent - (long)fraction + (long)(digits - 1 - last) + (long)(count - kept);
+        if (kept < count) {
+            big_mul_add(&n, 10, 1);
+            exp10--;
+            kept++;
+        }
+        // n * 10^exp10 lies in [10^(magnitude - 1), 10^magnitude)
+        long magnitude = (long)kept + exp10;
+        if (magnitude > 39) {
+            real = INFINITY;
+        } else if (magnitude >= -45) {
+            real = decimal_to_float(&n, (int)exp10);
+        }
+        if (isinf(real)) flags = JASS_LITERAL_OVERFLOW;
+    }
+    memcpy(value, &real, sizeof *value);
+    return flags;
+}
+
+uint8_t jass_decode_rawcode(const char *text, size_t length, uint32_t *value) {
+    *value = 0;
+    if (length < 2 || text[0] != '\'' || text[length - 1] != '\'') return JASS_LITERAL_INVALID;
+    uint8_t flags = 0;
+    uint32_t result = 0;
+    for (size_t i = 1; i + 1 < length; i++) {
+        if (i > 4) flags |= JASS_LITERAL_OVERFLOW;
+        result = (result << 8) | (unsigned char)text[i];
+    }
+    *value = result;
+    return flags;
+}
+
+typedef struct {
+    TSSymbol number;
+    TSSymbol real;
+    TSSymbol rawcode;
+} Ids;
+
+static TSSymbol symbol(const TSLanguage *language, const char *name) {
+    return ts_language_symbol_for_name(language, name, (uint32_t)strlen(name), true);
+}
+
+size_t jass_literals(TSNode root, const char *source, size_t length,
+                     JassLiteral *literals, size_t capacity) {
+    const TSLanguage *language = ts_node_language(root);
+    Ids ids = {symbol(language, "number"), symbol(language, "float"), symbol(language, "rawcode")};
+
+    size_t count = 0;
+    uint32_t index = 0;
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        TSSymbol kind = ts_node_symbol(node);
+        if ((kind == ids.number || kind == ids.real || kind == ids.rawcode) && !ts_node_is_missing(node)) {
+            if (count < capacity) {
+                JassLiteral *literal = &literals[count];
+                memset(literal, 0, sizeof *literal);
+                literal->node_index = index;
+                literal->start_byte = ts_node_start_byte(node);
+                literal->end_byte = ts_node_end_byte(node);
+                literal->kind = kind == ids.number ? JASS_LITERAL_NUMBER
+                              : kind == ids.real   ? JASS_LITERAL_FLOAT
+                                                   : JASS_LITERAL_RAWCODE;
+                const char *text = source + literal->start_byte;
+                size_t text_length = literal->end_byte - literal->start_byte;
+                if (literal->end_byte > length) {
+                    literal->flags = JASS_LITERAL_INVALID;
+                } else if (literal->kind == JASS_LITERAL_NUMBER) {
+                    literal->flags = jass_decode_number(text, text_length, &literal->value);
+                } else if (literal->kind == JASS_LITERAL_FLOAT) {
+                    literal->flags = jass_decode_float(text, text_length, &literal->value);
+                } else {
+                    literal->flags = jass_decode_rawcode(text, text_length, &literal->value);
+                }
+            }
+            count++;
+        }
+        index++;
+
+        // Pre-order, the same numbering as exportFlat
+        if (ts_tree_cursor_goto_first_child(&cursor)) continue;
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return count;
+            }
+        }
+    }
+}
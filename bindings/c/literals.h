@@ -0,0 +1,80 @@
+// Bulk decoding of the number, float and rawcode literals of a JASS tree.
+//
+// jass_literals() walks the whole tree once with a TSTreeCursor and, for
+// every literal, decodes its text from the source into a 32-bit value:
+//
+//   number   the `number` token of grammar.js: decimal, 0x/0X or $ hex,
+//            0b/0B binary, `_` separators, an l/L, u/U or uL/UL suffix.
+//            The value is the low 32 bits (so $FFFFFFFF is -1 as an int).
+//   float    the `float` token: 1.2, .3, 4., 1e5, 1.2e-3, an f/F suffix,
+//            `_` separators. The value is the bits of the nearest float,
+//            JASS reals being single precision.
+//   rawcode  the scanner's RAWCODE token ('A', 'hfoo'): the bytes between
+//            the quotes packed big-endian, so 'hfoo' is 0x68666F6F.
+//
+// Entries are written into a caller-provided buffer and carry the node's
+// pre-order index among all nodes (the index exportFlat gives it) and its
+// byte range; no string is created. Works with every grammar variant
+// (kinds are looked up by name); in jass_decls, literals inside opaque
+// function bodies are not seen.
+//
+// The jass_decode_* functions decode one literal's text on their own.
+
+#ifndef TREE_SITTER_JASS_LITERALS_H_
+#define TREE_SITTER_JASS_LITERALS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    JASS_LITERAL_NUMBER,
+    JASS_LITERAL_FLOAT,
+    JASS_LITERAL_RAWCODE,
+};
+
+enum {
+    // Integer beyond 32 bits, rawcode longer than 4 bytes (the value keeps
+    // the low 32 bits) or float beyond the float range (infinity)
+    JASS_LITERAL_OVERFLOW = 1 << 0,
+    // u/U and l/L suffixes of a number
+    JASS_LITERAL_UNSIGNED = 1 << 1,
+    JASS_LITERAL_LONG = 1 << 2,
+    // Text that is not a literal of its kind, e.g. a source that is not the
+    // one the tree was parsed from; the value is 0
+    JASS_LITERAL_INVALID = 1 << 3,
+};
+
+typedef struct {
+    uint32_t node_index;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    // int32 bits for numbers and rawcodes, IEEE-754 float bits for floats
+    uint32_t value;
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t reserved;
+} JassLiteral;
+
+// Writes the first `capacity` literals under `root` to `literals`, in
+// source order, and returns how many there are in total. If that is more
+// than `capacity`, call again with a larger buffer. `source` is the text
+// the tree was parsed from.
+size_t jass_literals(TSNode root, const char *source, size_t length,
+                     JassLiteral *literals, size_t capacity);
+
+// Each returns the JASS_LITERAL_* flags of `text` and stores its value.
+uint8_t jass_decode_number(const char *text, size_t length, uint32_t *value);
+uint8_t jass_decode_float(const char *text, size_t length, uint32_t *value);
+uint8_t jass_decode_rawcode(const char *text, size_t length, uint32_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_LITERALS_H_
@@ -0,0 +1,244 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "mapped.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#define JASS_MAP_WIN32
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define JASS_MAP_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <stdio.h>
+#endif
+
+#ifndef EFBIG
+#define EFBIG 27
+#endif
+
+static const char empty[1] = "";
+
+static void set_empty(JassMappedFile *file) {
+    file->data = empty;
+    file->length = 0;
+    file->mapped = false;
+    file->state = NULL;
+}
+
+// Grows a heap buffer by doubling; NULL when out of memory or at the
+// 4 GiB limit (capacity is then UINT32_MAX)
+static char *grow(char *buffer, size_t *capacity) {
+    size_t next = *capacity ? *capacity * 2 : 1 << 16;
+    if (next > UINT32_MAX || next < *capacity) next = UINT32_MAX;
+    if (next <= *capacity) return NULL;
+    char *grown = realloc(buffer, next);
+    if (grown) *capacity = next;
+    return grown;
+}
+
+static void set_buffer(JassMappedFile *file, char *buffer, size_t length) {
+    if (length == 0) {
+        free(buffer);
+        set_empty(file);
+        return;
+    }
+    file->data = buffer;
+    file->length = (uint32_t)length;
+    file->mapped = false;
+    file->state = buffer;
+}
+
+#if defined(JASS_MAP_POSIX)
+
+static int read_all(int fd, JassMappedFile *file) {
+    char *buffer = NULL;
+    size_t length = 0, capacity = 0;
+    for (;;) {
+        if (length == capacity) {
+            char *grown = grow(buffer, &capacity);
+            if (!grown) {
+                free(buffer);
+                return capacity == UINT32_MAX ? EFBIG : ENOMEM;
+            }
+            buffer = grown;
+        }
+        ssize_t n = read(fd, buffer + length, capacity - length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int error = errno;
+            free(buffer);
+            return error;
+        }
+        if (n == 0) break;
+        length += (size_t)n;
+    }
+    set_buffer(file, buffer, length);
+    return 0;
+}
+
+int jass_map_file(const char *path, JassMappedFile *file) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return errno;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int error = errno;
+        close(fd);
+        return error;
+    }
+    int result = 0;
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        // Pipes, devices, and files like /proc ones that report no size
+        result = read_all(fd, file);
+    } else if ((uint64_t)st.st_size > UINT32_MAX) {
+        result = EFBIG;
+    } else {
+        size_t length = (size_t)st.st_size;
+        void *data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            result = read_all(fd, file);
+        } else {
+#ifdef POSIX_MADV_SEQUENTIAL
+            // The lexer reads front to back
+            posix_madvise(data, length, POSIX_MADV_SEQUENTIAL);
+#endif
+            file->data = data;
+            file->length = (uint32_t)length;
+            file->mapped = true;
+            file->state = data;
+        }
+    }
+    close(fd);
+    return result;
+}
+
+void jass_unmap_file(JassMappedFile *file) {
+    if (file->mapped) {
+        munmap(file->state, file->length);
+    } else {
+        free(file->state);
+    }
+    set_empty(file);
+}
+
+#elif defined(JASS_MAP_WIN32)
+
+static int read_all(HANDLE handle, JassMappedFile *file) {
+    char *buffer = NULL;
+    size_t length = 0, capacity = 0;
+    for (;;) {
+        if (length == capacity) {
+            char *grown = grow(buffer, &capacity);
+            if (!grown) {
+                free(buffer);
+                return capacity == UINT32_MAX ? ERROR_FILE_TOO_LARGE : ERROR_NOT_ENOUGH_MEMORY;
+            }
+            buffer = grown;
+        }
+        DWORD chunk = capacity - length > 0x40000000 ? 0x40000000 : (DWORD)(capacity - length);
+        DWORD n = 0;
+        if (!ReadFile(handle, buffer + length, chunk, &n, NULL)) {
+            int error = (int)GetLastError();
+            free(buffer);
+            return error;
+        }
+        if (n == 0) break;
+        length += n;
+    }
+    set_buffer(file, buffer, length);
+    return 0;
+}
+
+int jass_map_file(const char *path, JassMappedFile *file) {
+    int wide_length = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    if (wide_length == 0) return (int)GetLastError();
+    WCHAR *wide = malloc((size_t)wide_length * sizeof(WCHAR));
+    if (!wide) return ERROR_NOT_ENOUGH_MEMORY;
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wide, wide_length);
+    HANDLE handle = CreateFileW(wide, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    free(wide);
+    if (handle == INVALID_HANDLE_VALUE) return (int)GetLastError();
+
+    int result = 0;
+    LARGE_INTEGER size;
+    if (GetFileType(handle) != FILE_TYPE_DISK || !GetFileSizeEx(handle, &size)) {
+        result = read_all(handle, file);
+    } else if ((uint64_t)size.QuadPart > UINT32_MAX) {
+        result = ERROR_FILE_TOO_LARGE;
+    } else if (size.QuadPart == 0) {
+        set_empty(file);
+    } else {
+        HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        // The view keeps the mapping alive
+        if (mapping) CloseHandle(mapping);
+        if (!view) {
+            result = read_all(handle, file);
+        } else {
+            file->data = view;
+            file->length = (uint32_t)size.QuadPart;
+            file->mapped = true;
+            file->state = view;
+        }
+    }
+    CloseHandle(handle);
+    return result;
+}
+
+void jass_unmap_file(JassMappedFile *file) {
+    if (file->mapped) {
+        UnmapViewOfFile(file->state);
+    } else {
+        free(file->state);
+    }
+    set_empty(file);
+}
+
+#else  // no mapping: buffered read
+
+int jass_map_file(const char *path, JassMappedFile *file) {
+    FILE *stream = fopen(path, "rb");
+    if (!stream) return errno ? errno : ENOENT;
+    char *buffer = NULL;
+    size_t length = 0, capacity = 0;
+    for (;;) {
+        if (length == capacity) {
+            char *grown = grow(buffer, &capacity);
+            if (!grown) {
+                free(buffer);
+                fclose(stream);
+                return capacity == UINT32_MAX ? EFBIG : ENOMEM;
+            }
+            buffer = grown;
+        }
+        size_t n = fread(buffer + length, 1, capacity - length, stream);
+        length += n;
+        if (n == 0) {
+            int failed = ferror(stream);
+            fclose(stream);
+            if (failed) {
+                free(buffer);
+                return EIO;
+            }
+            break;
+        }
+    }
+    set_buffer(file, buffer, length);
+    return 0;
+}
+
+void jass_unmap_file(JassMappedFile *file) {
+    free(file->state);
+    set_empty(file);
+}
+
+#endif
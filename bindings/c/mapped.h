@@ -0,0 +1,40 @@
+// Read-only access to a source file without copying it.
+//
+// jass_map_file() memory-maps the file (mmap, or a file mapping on
+// Windows), so a parser can read the UTF-8 bytes straight from the page
+// cache through a TSInput callback. Where mapping isn't available or fails
+// (pipes, special files, platforms without mmap) the file is read into
+// one heap buffer instead; `mapped` tells which.
+//
+// A mapped file must not be truncated while it is in use: pages past the
+// new end can no longer be read (SIGBUS on POSIX).
+
+#ifndef TREE_SITTER_JASS_MAPPED_H_
+#define TREE_SITTER_JASS_MAPPED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char *data;
+    uint32_t length;
+    bool mapped;
+    void *state;  // mapping or buffer, released by jass_unmap_file()
+} JassMappedFile;
+
+// Opens `path` (UTF-8) and fills *file. Returns 0, or the OS error code
+// (errno; GetLastError() on Windows). Files over 4 GiB, which tree-sitter
+// can't address, fail with EFBIG / ERROR_FILE_TOO_LARGE.
+int jass_map_file(const char *path, JassMappedFile *file);
+
+void jass_unmap_file(JassMappedFile *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_MAPPED_H_
@@ -0,0 +1,158 @@
+#include "outline.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// Ids of the kinds and fields the outline reads, in the tree's language
+typedef struct {
+    TSSymbol function_statement;
+    TSSymbol native_statement;
+    TSSymbol type_statement;
+    TSSymbol globals;
+    TSSymbol var_stmt;
+    TSSymbol var_decl;
+    TSSymbol constant;
+    TSSymbol array;
+    TSFieldId name;
+    TSFieldId parameters;
+    TSFieldId return_type;
+    TSFieldId type;
+    TSFieldId base;
+} Ids;
+
+static TSSymbol symbol(const TSLanguage *language, const char *name, bool named) {
+    return ts_language_symbol_for_name(language, name, (uint32_t)strlen(name), named);
+}
+
+static TSFieldId field(const TSLanguage *language, const char *name) {
+    return ts_language_field_id_for_name(language, name, (uint32_t)strlen(name));
+}
+
+static void resolve(const TSLanguage *language, Ids *ids) {
+    ids->function_statement = symbol(language, "function_statement", true);
+    ids->native_statement = symbol(language, "native_statement", true);
+    ids->type_statement = symbol(language, "type_statement", true);
+    ids->globals = symbol(language, "globals", true);
+    ids->var_stmt = symbol(language, "var_stmt", true);
+    ids->var_decl = symbol(language, "var_decl", true);
+    ids->constant = symbol(language, "constant", false);
+    ids->array = symbol(language, "array", false);
+    ids->name = field(language, "name");
+    ids->parameters = field(language, "parameters");
+    ids->return_type = field(language, "return_type");
+    ids->type = field(language, "type");
+    ids->base = field(language, "base");
+}
+
+typedef struct {
+    JassOutlineEntry *entries;
+    size_t capacity;
+    size_t count;
+} Output;
+
+static void push(Output *out, const JassOutlineEntry *entry) {
+    if (out->count < out->capacity) out->entries[out->count] = *entry;
+    out->count++;
+}
+
+static void begin(JassOutlineEntry *entry, uint8_t kind, TSNode node) {
+    memset(entry, 0, sizeof *entry);
+    entry->kind = kind;
+    entry->start_byte = ts_node_start_byte(node);
+    entry->end_byte = ts_node_end_byte(node);
+    TSPoint start = ts_node_start_point(node);
+    entry->start_row = start.row;
+    entry->start_column = start.column;
+}
+
+static void set_range(uint32_t *start, uint32_t *end, TSNode node) {
+    *start = ts_node_start_byte(node);
+    *end = ts_node_end_byte(node);
+}
+
+// Function, native or type statement under the cursor. Its children are
+// read up to the last signature field; the body that follows is skipped.
+static void declaration(TSTreeCursor *cursor, const Ids *ids, uint8_t kind, Output *out) {
+    JassOutlineEntry entry;
+    begin(&entry, kind, ts_tree_cursor_current_node(cursor));
+    bool named = false;
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+        do {
+            TSNode child = ts_tree_cursor_current_node(cursor);
+            TSFieldId field_id = ts_tree_cursor_current_field_id(cursor);
+            if (field_id == 0) {
+                if (ts_node_symbol(child) == ids->constant) entry.flags |= JASS_OUTLINE_CONSTANT;
+            } else if (field_id == ids->name) {
+                set_range(&entry.name_start, &entry.name_end, child);
+                named = true;
+            } else if (field_id == ids->parameters) {
+                set_range(&entry.parameters_start, &entry.parameters_end, child);
+            } else if (field_id == ids->return_type || field_id == ids->base) {
+                set_range(&entry.type_start, &entry.type_end, child);
+                break;
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    }
+    if (named) push(out, &entry);
+}
+
+// One entry per variable of each declaration in the globals block under
+// the cursor; initializers are not entered.
+static void globals(TSTreeCursor *cursor, const Ids *ids, Output *out) {
+    if (!ts_tree_cursor_goto_first_child(cursor)) return;
+    do {
+        if (ts_node_symbol(ts_tree_cursor_current_node(cursor)) != ids->var_stmt) continue;
+        uint8_t flags = 0;
+        uint32_t type_start = 0, type_end = 0;
+        ts_tree_cursor_goto_first_child(cursor);
+        do {
+            TSNode child = ts_tree_cursor_current_node(cursor);
+            TSSymbol child_symbol = ts_node_symbol(child);
+            if (child_symbol == ids->constant) {
+                flags |= JASS_OUTLINE_CONSTANT;
+            } else if (child_symbol == ids->array) {
+                flags |= JASS_OUTLINE_ARRAY;
+            } else if (ts_tree_cursor_current_field_id(cursor) == ids->type) {
+                set_range(&type_start, &type_end, child);
+            } else if (child_symbol == ids->var_decl) {
+                // The name is the first child of a var_decl
+                TSNode name = ts_node_child(child, 0);
+                if (ts_node_is_null(name) || ts_node_is_missing(name)) continue;
+                JassOutlineEntry entry;
+                begin(&entry, JASS_OUTLINE_GLOBAL, child);
+                entry.flags = flags;
+                set_range(&entry.name_start, &entry.name_end, name);
+                entry.type_start = type_start;
+                entry.type_end = type_end;
+                push(out, &entry);
+            }
+        } while (ts_tree_cursor_goto_next_sibling(cursor));
+        ts_tree_cursor_goto_parent(cursor);
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    ts_tree_cursor_goto_parent(cursor);
+}
+
+size_t jass_outline(TSNode root, JassOutlineEntry *entries, size_t capacity) {
+    Ids ids;
+    resolve(ts_node_language(root), &ids);
+    Output out = {entries, capacity, 0};
+
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+        do {
+            TSSymbol kind = ts_node_symbol(ts_tree_cursor_current_node(&cursor));
+            if (kind == ids.function_statement) {
+                declaration(&cursor, &ids, JASS_OUTLINE_FUNCTION, &out);
+            } else if (kind == ids.native_statement) {
+                declaration(&cursor, &ids, JASS_OUTLINE_NATIVE, &out);
+            } else if (kind == ids.type_statement) {
+                declaration(&cursor, &ids, JASS_OUTLINE_TYPE, &out);
+            } else if (kind == ids.globals) {
+                globals(&cursor, &ids, &out);
+            }
+        } while (ts_tree_cursor_goto_next_sibling(&cursor));
+    }
+    ts_tree_cursor_delete(&cursor);
+    return out.count;
+}
@@ -0,0 +1,68 @@
+// Outline of a JASS tree: its top-level declarations in one pass.
+//
+// jass_outline() moves a TSTreeCursor over the children of the root only:
+// functions, natives, types and the variables of each globals block. For
+// a declaration it reads the children up to its last signature field
+// (`return_type`, `base`) and never enters a function body, so the cost
+// is proportional to the number of top-level nodes, not to the size of
+// the tree. Entries hold byte ranges into the source rather than strings
+// and are written into a caller-provided buffer; nothing is allocated
+// apart from the cursor.
+//
+// Works with every grammar variant (node kinds and fields are looked up
+// by name in the tree's language).
+
+#ifndef TREE_SITTER_JASS_OUTLINE_H_
+#define TREE_SITTER_JASS_OUTLINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Values match JassSymbolKind and the symbol flags of symtab.h
+enum {
+    JASS_OUTLINE_FUNCTION,
+    JASS_OUTLINE_NATIVE,
+    JASS_OUTLINE_TYPE,
+    JASS_OUTLINE_GLOBAL,
+};
+
+enum {
+    JASS_OUTLINE_CONSTANT = 1 << 0,
+    JASS_OUTLINE_ARRAY = 1 << 1,
+};
+
+// One declaration. `type` is the return type of functions and natives,
+// the base of types and the variable type of globals; `parameters` is
+// `nothing` or the parameter list. Absent ranges are empty (start == end).
+typedef struct {
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    uint32_t start_row;
+    uint32_t start_column;
+    uint32_t name_start;
+    uint32_t name_end;
+    uint32_t type_start;
+    uint32_t type_end;
+    uint32_t parameters_start;
+    uint32_t parameters_end;
+} JassOutlineEntry;
+
+// Writes the first `capacity` declarations under `root` (a root node) to
+// `entries`, in source order, and returns how many there are in total. If
+// that is more than `capacity`, call again with a larger buffer.
+size_t jass_outline(TSNode root, JassOutlineEntry *entries, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_OUTLINE_H_
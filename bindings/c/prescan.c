@@ -0,0 +1,488 @@
+#include "prescan.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "keywords.h"
+
+// Same limit as the scanner (common/scanner.h)
+#ifndef JASS_RAWCODE_MAX_LEN
+#define JASS_RAWCODE_MAX_LEN 8
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JASS_PRESCAN_SSE2
+#include <emmintrin.h>
+// AVX2 is picked at run time; that needs GCC/Clang target attributes
+#if defined(__GNUC__) || defined(__clang__)
+#define JASS_PRESCAN_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define JASS_PRESCAN_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// --- Bit helpers ---
+
+static inline unsigned ctz64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctzll(x);
+#endif
+}
+
+// Index of the highest set bit
+static inline unsigned top64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return (unsigned)index;
+#else
+    return 63 - (unsigned)__builtin_clzll(x);
+#endif
+}
+
+static inline unsigned popcount64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    // __popcnt64 needs the POPCNT instruction; stay portable
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (unsigned)((x * 0x0101010101010101ull) >> 56);
+#else
+    return (unsigned)__builtin_popcountll(x);
+#endif
+}
+
+// Bits [i, 64)
+static inline uint64_t above(unsigned i) { return i >= 64 ? 0 : ~(uint64_t)0 << i; }
+
+// Bits [0, i)
+static inline uint64_t below(unsigned i) { return ~above(i); }
+
+// --- Classification: 64 bytes per step ---
+
+typedef struct {
+    uint64_t newline;  // \n
+    uint64_t blank;    // space, \t, \r
+    uint64_t cr;       // \r, which also ends a comment
+    uint64_t delim;    // " ' / backslash
+} Classes;
+
+typedef void (*ClassifyFn)(const uint8_t *block, Classes *out);
+
+static void classify_scalar(const uint8_t *block, Classes *out) {
+    Classes classes = {0, 0, 0, 0};
+    for (unsigned i = 0; i < 64; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        switch (block[i]) {
+            case '\n': classes.newline |= bit; break;
+            case '\r': classes.cr |= bit; classes.blank |= bit; break;
+            case ' ':
+            case '\t': classes.blank |= bit; break;
+            case '"':
+            case '\'':
+            case '/':
+            case '\\': classes.delim |= bit; break;
+            default: break;
+        }
+    }
+    *out = classes;
+}
+
+#ifdef JASS_PRESCAN_SSE2
+static void classify_sse2(const uint8_t *block, Classes *out) {
+    Classes classes = {0, 0, 0, 0};
+    for (unsigned lane = 0; lane < 4; lane++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(block + 16 * lane));
+        __m128i newline = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+        __m128i cr = _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'));
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                                  _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                                     cr);
+        __m128i delim = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                                  _mm_cmpeq_epi8(v, _mm_set1_epi8('\''))),
+                                     _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')),
+                                                  _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+        unsigned shift = 16 * lane;
+        classes.newline |= (uint64_t)(uint16_t)_mm_movemask_epi8(newline) << shift;
+        classes.blank |= (uint64_t)(uint16_t)_mm_movemask_epi8(blank) << shift;
+        classes.cr |= (uint64_t)(uint16_t)_mm_movemask_epi8(cr) << shift;
+        classes.delim |= (uint64_t)(uint16_t)_mm_movemask_epi8(delim) << shift;
+    }
+    *out = classes;
+}
+#endif
+
+#ifdef JASS_PRESCAN_AVX2
+__attribute__((target("avx2"))) static void classify_avx2(const uint8_t *block, Classes *out) {
+    Classes classes = {0, 0, 0, 0};
+    for (unsigned lane = 0; lane < 2; lane++) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(block + 32 * lane));
+        __m256i newline = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+        __m256i cr = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'));
+        __m256i blank = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                                        cr);
+        __m256i delim =
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\''))),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')),
+                                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))));
+        unsigned shift = 32 * lane;
+        classes.newline |= (uint64_t)(uint32_t)_mm256_movemask_epi8(newline) << shift;
+        classes.blank |= (uint64_t)(uint32_t)_mm256_movemask_epi8(blank) << shift;
+        classes.cr |= (uint64_t)(uint32_t)_mm256_movemask_epi8(cr) << shift;
+        classes.delim |= (uint64_t)(uint32_t)_mm256_movemask_epi8(delim) << shift;
+    }
+    *out = classes;
+}
+#endif
+
+#ifdef JASS_PRESCAN_NEON
+// One bit per byte of four compare results (0x00/0xff per byte)
+static inline uint64_t neon_movemask(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3) {
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bits = vld1q_u8(weights);
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(m0, bits), vandq_u8(m1, bits));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(m2, bits), vandq_u8(m3, bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static void classify_neon(const uint8_t *block, Classes *out) {
+    uint8x16_t newline[4], blank[4], cr[4], delim[4];
+    for (unsigned lane = 0; lane < 4; lane++) {
+        uint8x16_t v = vld1q_u8(block + 16 * lane);
+        newline[lane] = vceqq_u8(v, vdupq_n_u8('\n'));
+        cr[lane] = vceqq_u8(v, vdupq_n_u8('\r'));
+        blank[lane] = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t'))),
+                               cr[lane]);
+        delim[lane] = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('\''))),
+                               vorrq_u8(vceqq_u8(v, vdupq_n_u8('/')), vceqq_u8(v, vdupq_n_u8('\\'))));
+    }
+    out->newline = neon_movemask(newline[0], newline[1], newline[2], newline[3]);
+    out->blank = neon_movemask(blank[0], blank[1], blank[2], blank[3]);
+    out->cr = neon_movemask(cr[0], cr[1], cr[2], cr[3]);
+    out->delim = neon_movemask(delim[0], delim[1], delim[2], delim[3]);
+}
+#endif
+
+static ClassifyFn classify_impl;
+static const char *classify_name;
+
+// Racing threads pick the same implementation, so no synchronization
+static ClassifyFn select_classify(void) {
+    if (classify_impl) return classify_impl;
+    const char *name = "scalar";
+    ClassifyFn impl = classify_scalar;
+#if defined(JASS_PRESCAN_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        name = "avx2";
+        impl = classify_avx2;
+    } else {
+        name = "sse2";
+        impl = classify_sse2;
+    }
+#elif defined(JASS_PRESCAN_SSE2)
+    name = "sse2";
+    impl = classify_sse2;
+#elif defined(JASS_PRESCAN_NEON)
+    name = "neon";
+    impl = classify_neon;
+#endif
+    classify_name = name;
+    classify_impl = impl;
+    return impl;
+}
+
+const char *jass_prescan_isa(void) {
+    select_classify();
+    return classify_name;
+}
+
+// --- Region resolver and line heads ---
+
+typedef enum { CODE, COMMENT, STRING, RAWCODE } State;
+
+typedef struct {
+    const char *source;
+    uint32_t length;
+
+    // The resolver may run ahead of the current word after an escape or a
+    // rawcode, so it keeps its own position
+    State state;
+    uint32_t pos;
+    uint32_t region_start;
+    uint32_t region_end;  // RAWCODE only
+
+    // Carries into the next word
+    uint64_t line_start_carry;  // a line starts at its bit 0
+    uint64_t blank_carry;       // a blank run at a line start continues there
+    uint64_t string_carry;      // bit 63 of the string / rawcode masks
+    uint64_t rawcode_carry;
+    uint32_t row;
+    uint32_t line_start;
+} Prescan;
+
+typedef struct {
+    uint64_t comment;
+    uint64_t string;
+    uint64_t rawcode;
+} Regions;
+
+// Bits of [from, to) within the word at base
+static inline uint64_t span(uint32_t base, uint32_t from, uint32_t to) {
+    unsigned lo = from > base ? from - base : 0;
+    unsigned hi = to - base >= 64 ? 64 : to - base;
+    return lo >= hi ? 0 : above(lo) & below(hi);
+}
+
+static void resolve(Prescan *s, uint32_t base, const Classes *classes, Regions *out) {
+    const char *source = s->source;
+    uint32_t end = base + 64;
+    Regions regions = {0, 0, 0};
+
+    while (s->pos < end && s->pos < s->length) {
+        unsigned i = s->pos - base;
+        switch (s->state) {
+            case COMMENT: {
+                uint64_t stop = (classes->newline | classes->cr) & above(i);
+                if (!stop) {
+                    regions.comment |= span(base, s->region_start, end);
+                    s->pos = end;
+                    break;
+                }
+                uint32_t j = base + ctz64(stop);
+                regions.comment |= span(base, s->region_start, j);
+                s->state = CODE;
+                s->pos = j;
+                break;
+            }
+            case STRING: {
+                // Only quotes and backslashes matter inside a string
+                uint64_t delim = classes->delim & above(i);
+                char c = 0;
+                while (delim) {
+                    c = source[base + ctz64(delim)];
+                    if (c == '"' || c == '\\') break;
+                    delim &= delim - 1;
+                }
+                if (!delim) {
+                    s->pos = end;
+                    break;
+                }
+                uint32_t j = base + ctz64(delim);
+                if (c == '\\') {
+                    s->pos = j + 2;
+                } else {
+                    regions.string |= span(base, s->region_start, j + 1);
+                    s->state = CODE;
+                    s->pos = j + 1;
+                }
+                break;
+            }
+            case RAWCODE:
+                if (s->region_end > end) {
+                    s->pos = end;
+                    break;
+                }
+                regions.rawcode |= span(base, s->region_start, s->region_end);
+                s->state = CODE;
+                s->pos = s->region_end;
+                break;
+            case CODE: {
+                uint64_t delim = classes->delim & above(i);
+                if (!delim) {
+                    s->pos = end;
+                    break;
+                }
+                uint32_t j = base + ctz64(delim);
+                s->pos = j + 1;
+                switch (source[j]) {
+                    case '"':
+                        s->state = STRING;
+                        s->region_start = j;
+                        break;
+                    case '\'':
+                        for (uint32_t len = 0; len <= JASS_RAWCODE_MAX_LEN; len++) {
+                            uint32_t close = j + 1 + len;
+                            if (close >= s->length) break;
+                            if (source[close] == '\'') {
+                                s->state = RAWCODE;
+                                s->region_start = j;
+                                s->region_end = close + 1;
+                                break;
+                            }
+                        }
+                        break;
+                    case '/':
+                        if (j + 1 < s->length && source[j + 1] == '/') {
+                            s->state = COMMENT;
+                            s->region_start = j;
+                            s->pos = j + 2;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            }
+        }
+    }
+
+    // Open regions run on into the next word
+    if (s->state == STRING) regions.string |= span(base, s->region_start, end);
+    if (s->state == RAWCODE) regions.rawcode |= span(base, s->region_start, end);
+    if (s->state == COMMENT) regions.comment |= span(base, s->region_start, end);
+    *out = regions;
+}
+
+// First non-blank byte of each line, outside the interior of a region
+static uint64_t line_heads(Prescan *s, uint32_t base, const Classes *classes, const Regions *regions) {
+    uint64_t starts = (classes->newline << 1) | s->line_start_carry;
+    s->line_start_carry = classes->newline >> 63;
+
+    // Adding a start bit to a blank run carries to the run's first non-blank
+    uint64_t sum = classes->blank + starts;
+    uint64_t carry = sum < classes->blank;
+    uint64_t first = sum + s->blank_carry;
+    carry |= first < sum;
+    s->blank_carry = carry;
+    first &= ~classes->blank;
+
+    // A region may start at a head; a byte whose predecessor is in the same
+    // region is inside it
+    uint64_t inside_string = regions->string & ((regions->string << 1) | s->string_carry);
+    uint64_t inside_rawcode = regions->rawcode & ((regions->rawcode << 1) | s->rawcode_carry);
+    s->string_carry = regions->string >> 63;
+    s->rawcode_carry = regions->rawcode >> 63;
+
+    uint64_t valid = s->length - base >= 64 ? ~(uint64_t)0 : below(s->length - base);
+    return first & ~classes->newline & ~regions->comment & ~inside_string & ~inside_rawcode & valid;
+}
+
+static uint32_t head_keyword(const char *source, uint32_t length, uint32_t byte) {
+    uint32_t len = 0;
+    while (byte + len < length && len <= KEYWORD_MAX_LEN) {
+        char c = source[byte + len];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+              (len > 0 && c >= '0' && c <= '9'))) {
+            break;
+        }
+        len++;
+    }
+    return len == 0 || len > KEYWORD_MAX_LEN ? KW_NONE : keyword_lookup(source + byte, len);
+}
+
+typedef struct {
+    JassLineHead *items;
+    size_t count;
+    size_t capacity;
+} Heads;
+
+static bool push_heads(Prescan *s, uint32_t base, uint64_t heads, uint64_t newline, Heads *out) {
+    while (heads) {
+        unsigned j = ctz64(heads);
+        heads &= heads - 1;
+        uint64_t before = newline & below(j);
+        uint32_t line_start = before ? base + top64(before) + 1 : s->line_start;
+        if (out->count == out->capacity) {
+            size_t capacity = out->capacity ? out->capacity * 2 : 256;
+            JassLineHead *items = realloc(out->items, capacity * sizeof(JassLineHead));
+            if (!items) return false;
+            out->items = items;
+            out->capacity = capacity;
+        }
+        JassLineHead *head = &out->items[out->count++];
+        head->byte = base + j;
+        head->row = s->row + popcount64(before);
+        head->column = base + j - line_start;
+        head->keyword = head_keyword(s->source, s->length, base + j);
+    }
+    return true;
+}
+
+static bool prescan(const char *source, uint32_t length, JassMasks *masks, Heads *heads,
+                    bool *unterminated_string) {
+    ClassifyFn classify = select_classify();
+    Prescan s;
+    memset(&s, 0, sizeof(s));
+    s.source = source;
+    s.length = length;
+    s.state = CODE;
+    s.line_start_carry = 1;
+
+    size_t words = ((size_t)length + 63) / 64;
+    for (size_t w = 0; w < words; w++) {
+        uint32_t base = (uint32_t)(w * 64);
+        Classes classes;
+        if (length - base >= 64) {
+            classify((const uint8_t *)source + base, &classes);
+        } else {
+            // Zero padding matches no class
+            uint8_t tail[64] = {0};
+            memcpy(tail, source + base, length - base);
+            classify(tail, &classes);
+        }
+
+        Regions regions;
+        resolve(&s, base, &classes, &regions);
+        if (masks) {
+            masks->newline[w] = classes.newline;
+            masks->comment[w] = regions.comment;
+            masks->string[w] = regions.string;
+            masks->rawcode[w] = regions.rawcode;
+        }
+        uint64_t line = line_heads(&s, base, &classes, &regions);
+        if (heads && !push_heads(&s, base, line, classes.newline, heads)) return false;
+
+        s.row += popcount64(classes.newline);
+        if (classes.newline) s.line_start = base + top64(classes.newline) + 1;
+    }
+    *unterminated_string = s.state == STRING;
+    return true;
+}
+
+bool jass_prescan_masks(const char *source, uint32_t length, JassMasks *masks) {
+    size_t words = ((size_t)length + 63) / 64;
+    memset(masks, 0, sizeof(*masks));
+    // One block for all four masks
+    uint64_t *block = malloc((words ? words : 1) * 4 * sizeof(uint64_t));
+    if (!block) return false;
+    masks->newline = block;
+    masks->comment = block + words;
+    masks->string = block + 2 * words;
+    masks->rawcode = block + 3 * words;
+    masks->words = words;
+    prescan(source, length, masks, NULL, &masks->unterminated_string);
+    return true;
+}
+
+void jass_prescan_masks_free(JassMasks *masks) {
+    free(masks->newline);
+    memset(masks, 0, sizeof(*masks));
+}
+
+size_t jass_prescan_lines(const char *source, uint32_t length, JassLineHead **heads_out,
+                          bool *unterminated_string) {
+    Heads heads = {NULL, 0, 0};
+    if (!prescan(source, length, NULL, &heads, unterminated_string)) {
+        free(heads.items);
+        return (size_t)-1;
+    }
+    *heads_out = heads.items;
+    return heads.count;
+}
+
+void jass_prescan_free(JassLineHead *heads) { free(heads); }
@@ -0,0 +1,71 @@
+// Vectorized pre-scan of raw JASS bytes: region masks and line heads.
+//
+// The source is classified 64 bytes per step (AVX2, SSE2 or NEON, with a
+// scalar fallback) into newline, blank and delimiter bitmasks. A resolver
+// then walks only the delimiter bits to mark the three regions the
+// scanner lexes as units:
+//
+// - comments, from `//` up to the end of the line;
+// - strings, from `"` to the closing `"`, where `\` skips the next byte;
+// - rawcodes, from `'` to a closing `'` at most JASS_RAWCODE_MAX_LEN bytes
+//   later (a longer one is only the quote, as in the scanner).
+//
+// A line head is the first non-blank byte of a line when it isn't inside
+// one of these regions (a region may start there). Heads carry their
+// position and, when the line starts with a keyword, that keyword, so
+// `function`/`endfunction`/`globals`/`endglobals` lines can be found
+// without lexing the bytes in between.
+//
+// Bit i of word w in a mask stands for source byte 64 * w + i.
+
+#ifndef TREE_SITTER_JASS_PRESCAN_H_
+#define TREE_SITTER_JASS_PRESCAN_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint64_t *newline;
+    uint64_t *comment;
+    uint64_t *string;
+    uint64_t *rawcode;
+    size_t words;  // (length + 63) / 64 per mask
+    bool unterminated_string;
+} JassMasks;
+
+typedef struct {
+    uint32_t byte;
+    uint32_t row;
+    uint32_t column;
+    uint32_t keyword;  // Keyword of common/keywords.h, KW_NONE if none
+} JassLineHead;
+
+// Fills *masks with malloc'ed masks; false if out of memory. Release them
+// with jass_prescan_masks_free().
+bool jass_prescan_masks(const char *source, uint32_t length, JassMasks *masks);
+
+void jass_prescan_masks_free(JassMasks *masks);
+
+// Writes a malloc'ed array of the line heads in source order to *heads and
+// returns their count; (size_t)-1 if out of memory. *unterminated_string
+// is set if a string runs to the end of the source. Free the array with
+// jass_prescan_free().
+size_t jass_prescan_lines(const char *source, uint32_t length, JassLineHead **heads,
+                          bool *unterminated_string);
+
+void jass_prescan_free(JassLineHead *heads);
+
+// The instruction set the classifier dispatches to: "avx2", "sse2",
+// "neon" or "scalar".
+const char *jass_prescan_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_PRESCAN_H_
@@ -0,0 +1,263 @@
+#include "split.h"
+
+#include <stdlib.h>
+
+#include "keywords.h"
+#include "prescan.h"
+
+// Same limit as the scanner (common/scanner.h)
+#ifndef JASS_RAWCODE_MAX_LEN
+#define JASS_RAWCODE_MAX_LEN 8
+#endif
+
+typedef enum { TOP_LEVEL, IN_FUNCTION, IN_GLOBALS } Block;
+
+typedef struct {
+    const char *source;
+    uint32_t length;
+    uint32_t pos;
+    uint32_t row;
+    uint32_t column;
+} Cursor;
+
+static int peek(const Cursor *c, uint32_t ahead) {
+    return c->pos + ahead < c->length ? (unsigned char)c->source[c->pos + ahead] : -1;
+}
+
+static void step(Cursor *c) {
+    if (c->source[c->pos] == '\n') {
+        c->row++;
+        c->column = 0;
+    } else {
+        c->column++;
+    }
+    c->pos++;
+}
+
+static bool is_id_start(int ch) {
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+}
+
+static bool is_id_cont(int ch) {
+    return is_id_start(ch) || (ch >= '0' && ch <= '9');
+}
+
+static Keyword read_word(Cursor *c) {
+    uint32_t start = c->pos;
+    while (is_id_cont(peek(c, 0))) step(c);
+    uint32_t len = c->pos - start;
+    return len <= KEYWORD_MAX_LEN ? keyword_lookup(c->source + start, len) : KW_NONE;
+}
+
+// Skips a string literal; false if it runs to the end of the source
+static bool skip_string(Cursor *c) {
+    step(c);
+    for (;;) {
+        int ch = peek(c, 0);
+        if (ch < 0) return false;
+        step(c);
+        if (ch == '"') return true;
+        if (ch == '\\' && peek(c, 0) >= 0) step(c);
+    }
+}
+
+// Skips a rawcode like the scanner does: at most JASS_RAWCODE_MAX_LEN
+// characters, otherwise only the quote
+static void skip_rawcode(Cursor *c) {
+    step(c);
+    for (uint32_t len = 0; len <= JASS_RAWCODE_MAX_LEN && peek(c, len) >= 0; len++) {
+        if (peek(c, len) == '\'') {
+            for (uint32_t i = 0; i <= len; i++) step(c);
+            return;
+        }
+    }
+}
+
+typedef struct {
+    JassChunk *items;
+    size_t count;
+    size_t capacity;
+} Chunks;
+
+static bool push(Chunks *chunks, JassChunk chunk) {
+    if (chunks->count == chunks->capacity) {
+        size_t capacity = chunks->capacity ? chunks->capacity * 2 : 16;
+        JassChunk *items = realloc(chunks->items, capacity * sizeof(JassChunk));
+        if (!items) return false;
+        chunks->items = items;
+        chunks->capacity = capacity;
+    }
+    chunks->items[chunks->count++] = chunk;
+    return true;
+}
+
+typedef struct {
+    const JassLineHead *items;
+    size_t count;
+    size_t next;
+} Heads;
+
+// Whether a line starting with this keyword can open or close a block
+static bool is_structural(uint32_t kw) {
+    return kw == KW_FUNCTION || kw == KW_ENDFUNCTION || kw == KW_GLOBALS || kw == KW_ENDGLOBALS ||
+           kw == KW_NATIVE || kw == KW_TYPE || kw == KW_CONSTANT;
+}
+
+// Moves the cursor to the next line head at or after it (see prescan.h)
+// that starts with a structural keyword, or to the end of the source
+static void jump(Cursor *c, Heads *heads) {
+    while (heads->next < heads->count && (heads->items[heads->next].byte < c->pos ||
+                                          !is_structural(heads->items[heads->next].keyword))) {
+        heads->next++;
+    }
+    if (heads->next == heads->count) {
+        while (c->pos < c->length) step(c);
+        return;
+    }
+    const JassLineHead *head = &heads->items[heads->next];
+    c->pos = head->byte;
+    c->row = head->row;
+    c->column = head->column;
+}
+
+// Scans the whole source; false if the structure is ambiguous. Chunks are
+// pushed as boundaries are passed, the last one is left to the caller.
+//
+// Top-level lines are lexed here; inside a block only the first token of
+// each line matters, so the scan jumps from line head to line head found
+// by the vectorized pre-scan.
+static bool scan(Cursor *c, uint32_t target_size, Heads *heads, Chunks *chunks, JassChunk *open,
+                 bool *oom) {
+    Block block = TOP_LEVEL;
+    // Tokens seen so far on this line, and the start of the line
+    unsigned tokens = 0;
+    bool after_constant = false;
+    uint32_t line_pos = 0, line_row = 0;
+
+    while (c->pos < c->length) {
+        int ch = peek(c, 0);
+        if (ch == '\n') {
+            step(c);
+            tokens = 0;
+            after_constant = false;
+            line_pos = c->pos;
+            line_row = c->row;
+            continue;
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r') {
+            step(c);
+            continue;
+        }
+        if (ch == '/' && peek(c, 1) == '/') {
+            // Like the scanner, a comment also ends at \r
+            while (c->pos < c->length && peek(c, 0) != '\n' && peek(c, 0) != '\r') step(c);
+            continue;
+        }
+
+        bool first = tokens == 0 || (tokens == 1 && after_constant);
+        tokens++;
+        Keyword kw = KW_NONE;
+        if (ch == '"') {
+            if (block == TOP_LEVEL || !skip_string(c)) return false;
+            first = false;
+        } else if (ch == '\'') {
+            if (block == TOP_LEVEL) return false;
+            skip_rawcode(c);
+            first = false;
+        } else if (!is_id_start(ch)) {
+            if (block == TOP_LEVEL && first) return false;
+            step(c);
+            first = false;
+        } else {
+            kw = read_word(c);
+        }
+        if (kw == KW_CONSTANT && first && tokens == 1) {
+            after_constant = true;
+            continue;
+        }
+
+        bool opens = kw == KW_FUNCTION || kw == KW_GLOBALS ||
+                     kw == KW_NATIVE || kw == KW_TYPE;
+        // function_statement has no `constant`; only `constant native` opens
+        if (after_constant && kw != KW_NATIVE) opens = false;
+        if (first && block == TOP_LEVEL) {
+            if (!opens) return false;
+
+            // A declaration starts this line: cut here if the chunk is big enough
+            if (line_pos - open->start_byte >= target_size) {
+                open->end_byte = line_pos;
+                open->end_row = line_row;
+                open->end_column = 0;
+                if (!push(chunks, *open)) {
+                    *oom = true;
+                    return false;
+                }
+                open->start_byte = line_pos;
+                open->start_row = line_row;
+                open->start_column = 0;
+            }
+            if (kw == KW_FUNCTION) block = IN_FUNCTION;
+            if (kw == KW_GLOBALS) block = IN_GLOBALS;
+        } else if (first && (opens || kw == KW_ENDFUNCTION || kw == KW_ENDGLOBALS)) {
+            // A declaration inside a block, or the other block's closer
+            if (block == IN_FUNCTION && kw == KW_ENDFUNCTION) {
+                block = TOP_LEVEL;
+            } else if (block == IN_GLOBALS && kw == KW_ENDGLOBALS) {
+                block = TOP_LEVEL;
+            } else {
+                return false;
+            }
+        }
+
+        // The rest of a line in a block doesn't matter
+        if (block != TOP_LEVEL) {
+            jump(c, heads);
+            tokens = 0;
+            after_constant = false;
+            line_pos = c->pos - c->column;
+            line_row = c->row;
+        }
+    }
+    return true;
+}
+
+size_t jass_split(const char *source, uint32_t length, uint32_t target_size,
+                  JassChunk **chunks_out, bool *ambiguous) {
+    Cursor cursor = {source, length, 0, 0, 0};
+    Chunks chunks = {NULL, 0, 0};
+    JassChunk open = {0, 0, 0, 0, 0, 0};
+    bool oom = false;
+
+    JassLineHead *items = NULL;
+    bool unterminated = false;
+    size_t count = jass_prescan_lines(source, length, &items, &unterminated);
+    if (count == (size_t)-1) return 0;
+    Heads heads = {items, count, 0};
+
+    // An unterminated string swallows any boundary after it
+    bool split = !unterminated && scan(&cursor, target_size, &heads, &chunks, &open, &oom);
+    jass_prescan_free(items);
+    if (oom) {
+        free(chunks.items);
+        return 0;
+    }
+    if (!split) {
+        // Fall back to one chunk over everything
+        chunks.count = 0;
+        while (cursor.pos < cursor.length) step(&cursor);
+        open.start_byte = open.start_row = open.start_column = 0;
+    }
+    open.end_byte = cursor.pos;
+    open.end_row = cursor.row;
+    open.end_column = cursor.column;
+    if (!push(&chunks, open)) {
+        free(chunks.items);
+        return 0;
+    }
+
+    *ambiguous = !split;
+    *chunks_out = chunks.items;
+    return chunks.count;
+}
+
+void jass_split_free(JassChunk *chunks) { free(chunks); }
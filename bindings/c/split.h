@@ -0,0 +1,55 @@
+// Splitting one large JASS source into independently parsable chunks.
+//
+// jass_split() pre-scans a source for top-level declaration boundaries
+// (`function`, `native`, `constant native`, `type`, `globals`) and cuts
+// it into chunks of at least `target_size` bytes, each starting at such a
+// boundary. Comments, strings and rawcodes are skipped as units, and words
+// are classified with the scanner's keyword table (common/keywords.h).
+// Inside blocks only the line heads found by the vectorized pre-scan
+// (prescan.h) are looked at.
+//
+// Each chunk can then be parsed on its own thread with the chunk as the
+// parser's only included range (ts_parser_set_included_ranges), which
+// keeps node offsets and points relative to the whole source.
+//
+// The split is only made when every top-level line starts a declaration
+// and every block is closed before the next one opens, so each chunk parses
+// exactly as it would within the whole file. Otherwise (stray closers,
+// a function missing its endfunction, loose top-level statements, an
+// unterminated string) the result is one chunk covering the whole source
+// and *ambiguous is set.
+
+#ifndef TREE_SITTER_JASS_SPLIT_H_
+#define TREE_SITTER_JASS_SPLIT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Field layout of TSRange: a chunk can be passed as one
+typedef struct {
+    uint32_t start_row;
+    uint32_t start_column;
+    uint32_t end_row;
+    uint32_t end_column;
+    uint32_t start_byte;
+    uint32_t end_byte;
+} JassChunk;
+
+// Writes a malloc'ed array of chunks in source order to *chunks and
+// returns their count (at least 1), or 0 if out of memory. Free the array
+// with jass_split_free().
+size_t jass_split(const char *source, uint32_t length, uint32_t target_size,
+                  JassChunk **chunks, bool *ambiguous);
+
+void jass_split_free(JassChunk *chunks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_SPLIT_H_
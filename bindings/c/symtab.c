@@ -0,0 +1,203 @@
+#include "symtab.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define HEADER_SIZE 40
+#define RECORD_SIZE 32
+
+static void put32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+uint64_t jass_symtab_hash(const char *source, uint32_t length) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)source[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+typedef struct {
+    const char *name;
+    uint32_t length;
+    uint32_t index;
+} SortKey;
+
+static int compare_names(const char *a, size_t a_length, const char *b, size_t b_length) {
+    size_t n = a_length < b_length ? a_length : b_length;
+    int order = memcmp(a, b, n);
+    if (order != 0) return order;
+    return a_length < b_length ? -1 : a_length > b_length;
+}
+
+// Ties keep source order, so the first duplicate is found first
+static int compare_keys(const void *a, const void *b) {
+    const SortKey *x = a, *y = b;
+    int order = compare_names(x->name, x->length, y->name, y->length);
+    if (order != 0) return order;
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+static uint32_t put_string(uint8_t *strings, uint32_t *used, const char *text, uint32_t length) {
+    uint32_t offset = *used;
+    memcpy(strings + offset, text, length);
+    strings[offset + length] = 0;
+    *used += length + 1;
+    return offset;
+}
+
+bool jass_symtab_build(uint64_t source_hash, uint32_t source_length, const char *grammar, uint32_t abi_version,
+                       const JassSymbolInput *symbols, size_t count, uint8_t **data, size_t *length) {
+    uint64_t string_bytes = 1;  // offset 0 is the empty string
+    for (size_t i = 0; i < count; i++) {
+        string_bytes += (uint64_t)symbols[i].name_length + symbols[i].type_length +
+                        symbols[i].parameters_length + 3;
+    }
+    string_bytes = (string_bytes + 3) & ~(uint64_t)3;
+    uint64_t total = HEADER_SIZE + (uint64_t)count * (RECORD_SIZE + 4) + string_bytes;
+    if (total > UINT32_MAX) return false;
+
+    uint8_t *out = calloc(1, (size_t)total);
+    SortKey *keys = malloc((count ? count : 1) * sizeof(SortKey));
+    if (!out || !keys) {
+        free(out);
+        free(keys);
+        return false;
+    }
+
+    memcpy(out, "JSYM", 4);
+    put32(out + 4, JASS_SYMTAB_VERSION);
+    put32(out + 8, (uint32_t)source_hash);
+    put32(out + 12, (uint32_t)(source_hash >> 32));
+    put32(out + 16, source_length);
+    put32(out + 20, (uint32_t)count);
+    put32(out + 24, (uint32_t)string_bytes);
+    uint64_t grammar_hash = jass_symtab_hash(grammar, (uint32_t)strlen(grammar));
+    put32(out + 28, abi_version);
+    put32(out + 32, (uint32_t)grammar_hash);
+    put32(out + 36, (uint32_t)(grammar_hash >> 32));
+
+    uint8_t *records = out + HEADER_SIZE;
+    uint8_t *index = records + count * RECORD_SIZE;
+    uint8_t *strings = index + count * 4;
+    uint32_t used = 1;
+    for (size_t i = 0; i < count; i++) {
+        const JassSymbolInput *symbol = &symbols[i];
+        uint8_t *record = records + i * RECORD_SIZE;
+        record[0] = symbol->kind;
+        record[1] = symbol->flags;
+        put32(record + 4, put_string(strings, &used, symbol->name, symbol->name_length));
+        put32(record + 8, symbol->type_length ? put_string(strings, &used, symbol->type, symbol->type_length) : 0);
+        put32(record + 12, symbol->parameters_length
+                               ? put_string(strings, &used, symbol->parameters, symbol->parameters_length)
+                               : 0);
+        put32(record + 16, symbol->start_byte);
+        put32(record + 20, symbol->end_byte);
+        put32(record + 24, symbol->start_row);
+        put32(record + 28, symbol->start_column);
+        keys[i].name = symbol->name;
+        keys[i].length = symbol->name_length;
+        keys[i].index = (uint32_t)i;
+    }
+
+    qsort(keys, count, sizeof(SortKey), compare_keys);
+    for (size_t i = 0; i < count; i++) put32(index + i * 4, keys[i].index);
+    free(keys);
+
+    *data = out;
+    *length = (size_t)total;
+    return true;
+}
+
+void jass_symtab_free(uint8_t *data) { free(data); }
+
+bool jass_symtab_open(const void *data, size_t length, JassSymtab *table) {
+    const uint8_t *bytes = data;
+    if (length < HEADER_SIZE || memcmp(bytes, "JSYM", 4) != 0) return false;
+    if (get32(bytes + 4) != JASS_SYMTAB_VERSION) return false;
+
+    uint32_t count = get32(bytes + 20);
+    uint32_t string_bytes = get32(bytes + 24);
+    if (HEADER_SIZE + (uint64_t)count * (RECORD_SIZE + 4) + string_bytes > length) return false;
+
+    const uint8_t *records = bytes + HEADER_SIZE;
+    const uint8_t *index = records + (size_t)count * RECORD_SIZE;
+    const uint8_t *strings = index + (size_t)count * 4;
+    // Every string ends before the section does once its last byte is NUL
+    if (string_bytes == 0 || strings[string_bytes - 1] != 0) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *record = records + (size_t)i * RECORD_SIZE;
+        if (record[0] > JASS_SYMBOL_GLOBAL) return false;
+        if (get32(record + 4) >= string_bytes || get32(record + 8) >= string_bytes ||
+            get32(record + 12) >= string_bytes) {
+            return false;
+        }
+        if (get32(index + (size_t)i * 4) >= count) return false;
+    }
+    // jass_symtab_find() bisects the index, so it must be in compare_keys
+    // order; the strings are NUL-terminated by now
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t a = get32(index + (size_t)(i - 1) * 4), b = get32(index + (size_t)i * 4);
+        const char *a_name = (const char *)strings + get32(records + (size_t)a * RECORD_SIZE + 4);
+        const char *b_name = (const char *)strings + get32(records + (size_t)b * RECORD_SIZE + 4);
+        int order = compare_names(a_name, strlen(a_name), b_name, strlen(b_name));
+        if (order > 0 || (order == 0 && a >= b)) return false;
+    }
+
+    table->data = bytes;
+    table->length = length;
+    table->source_hash = (uint64_t)get32(bytes + 8) | (uint64_t)get32(bytes + 12) << 32;
+    table->source_length = get32(bytes + 16);
+    table->count = count;
+    table->abi_version = get32(bytes + 28);
+    table->grammar_hash = (uint64_t)get32(bytes + 32) | (uint64_t)get32(bytes + 36) << 32;
+    return true;
+}
+
+static const char *strings_of(const JassSymtab *table) {
+    return (const char *)table->data + HEADER_SIZE + (size_t)table->count * (RECORD_SIZE + 4);
+}
+
+void jass_symtab_get(const JassSymtab *table, uint32_t index, JassSymbol *symbol) {
+    const uint8_t *record = table->data + HEADER_SIZE + (size_t)index * RECORD_SIZE;
+    const char *strings = strings_of(table);
+    symbol->kind = record[0];
+    symbol->flags = record[1];
+    symbol->name = strings + get32(record + 4);
+    symbol->type = strings + get32(record + 8);
+    symbol->parameters = strings + get32(record + 12);
+    symbol->start_byte = get32(record + 16);
+    symbol->end_byte = get32(record + 20);
+    symbol->start_row = get32(record + 24);
+    symbol->start_column = get32(record + 28);
+}
+
+int64_t jass_symtab_find(const JassSymtab *table, const char *name, size_t length) {
+    const uint8_t *records = table->data + HEADER_SIZE;
+    const uint8_t *index = records + (size_t)table->count * RECORD_SIZE;
+    const char *strings = strings_of(table);
+    // Lower bound over the name index
+    uint32_t lo = 0, hi = table->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const char *candidate = strings + get32(records + (size_t)get32(index + (size_t)mid * 4) * RECORD_SIZE + 4);
+        if (compare_names(candidate, strlen(candidate), name, length) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == table->count) return -1;
+    uint32_t record = get32(index + (size_t)lo * 4);
+    const char *found = strings + get32(records + (size_t)record * RECORD_SIZE + 4);
+    return compare_names(found, strlen(found), name, length) == 0 ? (int64_t)record : -1;
+}
@@ -0,0 +1,125 @@
+// Compact binary symbol tables of JASS sources, for on-disk caches.
+//
+// A table holds the top-level declarations of one source: functions,
+// natives, types and globals, with their type, parameter list, flags and
+// position. It is keyed by a hash of the source bytes and records the
+// grammar it was extracted with (the language name, e.g. "jass_chain", and
+// its ABI version), so a cache can map the table of an unchanged file
+// (common.j, Blizzard.j, map headers) instead of parsing the file again,
+// and never serves one variant's table to another.
+//
+// Layout, little-endian, every section 4-byte aligned:
+//
+//   header   magic "JSYM", version, source hash (u64), source length,
+//            symbol count, string bytes, language ABI version, grammar
+//            hash (u64, jass_symtab_hash of the language name)
+//   records  count x 32 bytes, in source order:
+//            kind (u8), flags (u8), 2 reserved bytes, then u32 name, type
+//            and parameters offsets into the strings, start byte, end
+//            byte, start row, start column
+//   index    count x u32 record numbers sorted by name (bytewise)
+//   strings  NUL-terminated names, types and parameter lists
+//
+// jass_symtab_open() validates every offset and the order of the name
+// index, so a truncated or foreign file is rejected rather than read out
+// of bounds or searched wrongly. Tables are built by the
+// bindings from their trees; this file only knows the format.
+
+#ifndef TREE_SITTER_JASS_SYMTAB_H_
+#define TREE_SITTER_JASS_SYMTAB_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever the layout or what is extracted changes, which
+// invalidates existing cache files
+#define JASS_SYMTAB_VERSION 2
+
+typedef enum {
+    JASS_SYMBOL_FUNCTION,
+    JASS_SYMBOL_NATIVE,
+    JASS_SYMBOL_TYPE,
+    JASS_SYMBOL_GLOBAL,
+} JassSymbolKind;
+
+enum {
+    JASS_SYMBOL_CONSTANT = 1 << 0,
+    JASS_SYMBOL_ARRAY = 1 << 1,
+};
+
+// A symbol to store; strings are byte ranges, not NUL-terminated.
+// `type` is the return type of functions and natives, the base of types
+// and the variable type of globals. `parameters` is the parameter list
+// text (`nothing` or `unit u, real x`), empty for types and globals.
+typedef struct {
+    uint8_t kind;
+    uint8_t flags;
+    const char *name;
+    uint32_t name_length;
+    const char *type;
+    uint32_t type_length;
+    const char *parameters;
+    uint32_t parameters_length;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    uint32_t start_row;
+    uint32_t start_column;
+} JassSymbolInput;
+
+// A stored symbol; strings are NUL-terminated and point into the table.
+typedef struct {
+    uint8_t kind;
+    uint8_t flags;
+    const char *name;
+    const char *type;
+    const char *parameters;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    uint32_t start_row;
+    uint32_t start_column;
+} JassSymbol;
+
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    uint64_t source_hash;
+    uint32_t source_length;
+    uint32_t count;
+    uint32_t abi_version;
+    uint64_t grammar_hash;
+} JassSymtab;
+
+// 64-bit FNV-1a of the source bytes, the cache key
+uint64_t jass_symtab_hash(const char *source, uint32_t length);
+
+// Serializes `symbols`, extracted from a tree of the language named
+// `grammar` (ts_language_name) with `abi_version`
+// (ts_language_abi_version), into a malloc'ed buffer; false if out of
+// memory or over 4 GiB. Free it with jass_symtab_free().
+bool jass_symtab_build(uint64_t source_hash, uint32_t source_length, const char *grammar, uint32_t abi_version,
+                       const JassSymbolInput *symbols, size_t count, uint8_t **data, size_t *length);
+
+void jass_symtab_free(uint8_t *data);
+
+// Validates a serialized table (e.g. a mapped cache file) and fills *table
+// with a view of it; false if `data` is not a table of this version. The
+// source and grammar fields are left to the caller to compare.
+bool jass_symtab_open(const void *data, size_t length, JassSymtab *table);
+
+// The symbol at `index` (< count), in source order
+void jass_symtab_get(const JassSymtab *table, uint32_t index, JassSymbol *symbol);
+
+// Index of a symbol named name[0..length), or -1. With duplicates, the
+// first in source order.
+int64_t jass_symtab_find(const JassSymtab *table, const char *name, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_SYMTAB_H_
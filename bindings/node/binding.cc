@@ -4,6 +4,19 @@ typedef struct TSLanguage TSLanguage;
 
 extern "C" TSLanguage *tree_sitter_jass();
 
+void InitScannerStats(Napi::Env env, Napi::Object exports);
+
+// Functions that call into the tree-sitter runtime, when it is linked
+#ifdef JASS_RUNTIME
+void InitCheckIds(Napi::Env env, Napi::Object exports);
+void InitExportFlat(Napi::Env env, Napi::Object exports);
+void InitLiterals(Napi::Env env, Napi::Object exports);
+void InitOutline(Napi::Env env, Napi::Object exports);
+void InitParseMany(Napi::Env env, Napi::Object exports);
+void InitParseSplit(Napi::Env env, Napi::Object exports);
+void InitSymbols(Napi::Env env, Napi::Object exports);
+#endif
+
 // "tree-sitter", "language" hashed with BLAKE2
 const napi_type_tag LANGUAGE_TYPE_TAG = {
   0xaa0c75c4be73a8e7, 0xce6c89301c1fb8f4
@@ -14,6 +27,19 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
     auto language = Napi::External<TSLanguage>::New(env, tree_sitter_jass());
     language.TypeTag(&LANGUAGE_TYPE_TAG);
     exports["language"] = language;
+
+    InitScannerStats(env, exports);
+
+#ifdef JASS_RUNTIME
+    InitCheckIds(env, exports);
+    InitExportFlat(env, exports);
+    InitLiterals(env, exports);
+    InitOutline(env, exports);
+    InitParseMany(env, exports);
+    InitParseSplit(env, exports);
+    InitSymbols(env, exports);
+#endif
+
     return exports;
 }
 
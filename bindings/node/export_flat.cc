@@ -0,0 +1,233 @@
+// exportFlat: parses a source and returns its whole tree as flat columns.
+//
+// Walking a large tree through node-tree-sitter allocates a JS object per
+// SyntaxNode. Here the tree is walked once in C with a TSTreeCursor and
+// written into a single ArrayBuffer as a struct of arrays, one entry per
+// node in pre-order (so a node's descendants directly follow it):
+//
+//   start, end      Uint32Array  byte range
+//   parent          Int32Array   index of the parent, -1 for the root
+//   nextSibling     Int32Array   index of the next sibling, -1 for the last
+//   kind            Uint16Array  kind id, see `kinds` in ids.js
+//   field           Uint16Array  field id of the node in its parent, 0 if none
+//   flags           Uint8Array   FLAG_NAMED | FLAG_ERROR | FLAG_MISSING | FLAG_EXTRA
+//
+// The columns are views into `buffer`, wider columns first so every view
+// is aligned.
+//
+// parseFile(path) returns the same columns for a file. It maps the file
+// (bindings/c/mapped.c), parses it in place on the libuv thread pool, and
+// never creates a JS string of the source.
+
+#include <napi.h>
+#include <tree_sitter/api.h>
+
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "languages.h"
+#include "mapped_input.h"
+
+namespace {
+
+enum : uint8_t {
+    FLAG_NAMED = 1 << 0,
+    FLAG_ERROR = 1 << 1,
+    FLAG_MISSING = 1 << 2,
+    FLAG_EXTRA = 1 << 3,
+};
+
+struct Columns {
+    std::vector<uint32_t> start, end;
+    std::vector<int32_t> parent, next_sibling;
+    std::vector<uint16_t> kind, field;
+    std::vector<uint8_t> flags;
+
+    int32_t push(const TSTreeCursor &cursor, TSNode node, int32_t parent_index) {
+        auto index = static_cast<int32_t>(kind.size());
+        start.push_back(ts_node_start_byte(node));
+        end.push_back(ts_node_end_byte(node));
+        parent.push_back(parent_index);
+        next_sibling.push_back(-1);
+        kind.push_back(ts_node_symbol(node));
+        field.push_back(ts_tree_cursor_current_field_id(&cursor));
+        flags.push_back((ts_node_is_named(node) ? FLAG_NAMED : 0) |
+                        (ts_node_is_error(node) ? FLAG_ERROR : 0) |
+                        (ts_node_is_missing(node) ? FLAG_MISSING : 0) |
+                        (ts_node_is_extra(node) ? FLAG_EXTRA : 0));
+        return index;
+    }
+};
+
+void flatten(TSTree *tree, Columns &columns) {
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    // Indices of the current node and its ancestors
+    std::vector<int32_t> path = {columns.push(cursor, ts_tree_cursor_current_node(&cursor), -1)};
+    for (;;) {
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            path.push_back(columns.push(cursor, ts_tree_cursor_current_node(&cursor), path.back()));
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return;
+            }
+            path.pop_back();
+        }
+        int32_t previous = path.back();
+        path.back() = columns.push(cursor, ts_tree_cursor_current_node(&cursor), columns.parent[previous]);
+        columns.next_sibling[previous] = path.back();
+    }
+}
+
+template <typename T>
+size_t copy_column(uint8_t *base, size_t offset, const std::vector<T> &column) {
+    std::memcpy(base + offset, column.data(), column.size() * sizeof(T));
+    return offset + column.size() * sizeof(T);
+}
+
+Napi::Object flat_object(Napi::Env env, const Columns &columns) {
+    size_t count = columns.kind.size();
+    auto buffer = Napi::ArrayBuffer::New(env, count * (4 * sizeof(uint32_t) + 2 * sizeof(uint16_t) + 1));
+    auto *base = static_cast<uint8_t *>(buffer.Data());
+
+    auto result = Napi::Object::New(env);
+    result["count"] = Napi::Number::New(env, static_cast<double>(count));
+    result["buffer"] = buffer;
+    size_t offset = 0;
+    result["start"] = Napi::Uint32Array::New(env, count, buffer, offset);
+    offset = copy_column(base, offset, columns.start);
+    result["end"] = Napi::Uint32Array::New(env, count, buffer, offset);
+    offset = copy_column(base, offset, columns.end);
+    result["parent"] = Napi::Int32Array::New(env, count, buffer, offset);
+    offset = copy_column(base, offset, columns.parent);
+    result["nextSibling"] = Napi::Int32Array::New(env, count, buffer, offset);
+    offset = copy_column(base, offset, columns.next_sibling);
+    result["kind"] = Napi::Uint16Array::New(env, count, buffer, offset);
+    offset = copy_column(base, offset, columns.kind);
+    result["field"] = Napi::Uint16Array::New(env, count, buffer, offset);
+    offset = copy_column(base, offset, columns.field);
+    result["flags"] = Napi::Uint8Array::New(env, count, buffer, offset);
+    copy_column(base, offset, columns.flags);
+    return result;
+}
+
+std::string variant_option(const Napi::CallbackInfo &info) {
+    if (info.Length() > 1 && info[1].IsObject()) {
+        auto options = info[1].As<Napi::Object>();
+        if (options.Has("variant") && options.Get("variant").IsString()) {
+            return options.Get("variant").As<Napi::String>().Utf8Value();
+        }
+    }
+    return "jass";
+}
+
+// exportFlat(source: string | Buffer, options?: {variant?: string})
+Napi::Value ExportFlat(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    std::string source;
+    if (info.Length() > 0 && info[0].IsString()) {
+        source = info[0].As<Napi::String>().Utf8Value();
+    } else if (info.Length() > 0 && info[0].IsBuffer()) {
+        auto buffer = info[0].As<Napi::Buffer<char>>();
+        source.assign(buffer.Data(), buffer.Length());
+    } else {
+        throw Napi::TypeError::New(env, "exportFlat: expected a source string or Buffer");
+    }
+
+    std::string variant = variant_option(info);
+    const TSLanguage *language = variant_language(variant);
+    if (!language) {
+        throw Napi::TypeError::New(env, "exportFlat: grammar variant '" + variant + "' is not built");
+    }
+
+    TSParser *parser = ts_parser_new();
+    if (!ts_parser_set_language(parser, language)) {
+        ts_parser_delete(parser);
+        throw Napi::Error::New(env, "exportFlat: grammar ABI is not supported by the linked tree-sitter runtime");
+    }
+    TSTree *tree = ts_parser_parse_string(parser, nullptr, source.data(), static_cast<uint32_t>(source.size()));
+    ts_parser_delete(parser);
+
+    Columns columns;
+    flatten(tree, columns);
+    ts_tree_delete(tree);
+    return flat_object(env, columns);
+}
+
+class ParseFileWorker : public Napi::AsyncWorker {
+  public:
+    ParseFileWorker(Napi::Env env, std::string path, const TSLanguage *language)
+        : Napi::AsyncWorker(env),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          path_(std::move(path)),
+          language_(language) {}
+
+    Napi::Promise Promise() { return deferred_.Promise(); }
+
+    void Execute() override {
+        JassMappedFile file;
+        int error = jass_map_file(path_.c_str(), &file);
+        if (error != 0) {
+            // errno, or GetLastError() on Windows: both are system_category codes
+            SetError("parseFile: cannot read " + path_ + ": " + std::system_category().message(error));
+            return;
+        }
+        TSParser *parser = ts_parser_new();
+        if (!ts_parser_set_language(parser, language_)) {
+            ts_parser_delete(parser);
+            jass_unmap_file(&file);
+            SetError("parseFile: grammar ABI is not supported by the linked tree-sitter runtime");
+            return;
+        }
+        TSTree *tree = ts_parser_parse(parser, nullptr, mapped_input(file));
+        ts_parser_delete(parser);
+        flatten(tree, columns_);
+        ts_tree_delete(tree);
+        jass_unmap_file(&file);
+    }
+
+    void OnOK() override { deferred_.Resolve(flat_object(Env(), columns_)); }
+
+    void OnError(const Napi::Error &error) override { deferred_.Reject(error.Value()); }
+
+  private:
+    Napi::Promise::Deferred deferred_;
+    std::string path_;
+    const TSLanguage *language_;
+    Columns columns_;
+};
+
+// parseFile(path: string, options?: {variant?: string}): Promise
+Napi::Value ParseFile(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        throw Napi::TypeError::New(env, "parseFile: expected a path");
+    }
+    std::string variant = variant_option(info);
+    const TSLanguage *language = variant_language(variant);
+    if (!language) {
+        throw Napi::TypeError::New(env, "parseFile: grammar variant '" + variant + "' is not built");
+    }
+    auto *worker = new ParseFileWorker(env, info[0].As<Napi::String>().Utf8Value(), language);
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+}
+
+}  // namespace
+
+void InitExportFlat(Napi::Env env, Napi::Object exports) {
+    exports["exportFlat"] = Napi::Function::New(env, ExportFlat, "exportFlat");
+    exports["parseFile"] = Napi::Function::New(env, ParseFile, "parseFile");
+    auto flags = Napi::Object::New(env);
+    flags["NAMED"] = Napi::Number::New(env, FLAG_NAMED);
+    flags["ERROR"] = Napi::Number::New(env, FLAG_ERROR);
+    flags["MISSING"] = Napi::Number::New(env, FLAG_MISSING);
+    flags["EXTRA"] = Napi::Number::New(env, FLAG_EXTRA);
+    flags.Freeze();
+    exports["flatFlags"] = flags;
+}
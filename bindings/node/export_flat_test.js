@@ -0,0 +1,74 @@
+// node --test bindings/node/*_test.js (after `npm install` builds the addon)
+
+const assert = require("node:assert");
+const { test } = require("node:test");
+
+const jass = require("./index");
+
+// exportFlat is only built when the `tree-sitter` runtime is installed
+const skip = !jass.exportFlat && "exportFlat is not built (install the tree-sitter package)";
+
+const source = "function Test takes nothing returns nothing\nendfunction\n";
+
+test("exportFlat returns aligned columns over one buffer", { skip }, () => {
+  const flat = jass.exportFlat(source);
+  const columns = [
+    ["start", Uint32Array],
+    ["end", Uint32Array],
+    ["parent", Int32Array],
+    ["nextSibling", Int32Array],
+    ["kind", Uint16Array],
+    ["field", Uint16Array],
+    ["flags", Uint8Array],
+  ];
+  let offset = 0;
+  for (const [name, type] of columns) {
+    const column = flat[name];
+    assert.ok(column instanceof type, name);
+    assert.strictEqual(column.buffer, flat.buffer, name);
+    assert.strictEqual(column.length, flat.count, name);
+    // wider columns first, so each view starts where the previous one ends
+    assert.strictEqual(column.byteOffset, offset, name);
+    offset += column.byteLength;
+  }
+  assert.ok(flat.buffer.byteLength >= offset);
+});
+
+test("exportFlat lists the tree in pre-order", { skip }, () => {
+  const { count, start, end, parent, nextSibling, kind, field, flags } = jass.exportFlat(source);
+  const { NAMED } = jass.flatFlags;
+
+  assert.strictEqual(kind[0], jass.kinds.program);
+  assert.strictEqual(parent[0], -1);
+  assert.strictEqual(nextSibling[0], -1);
+  assert.strictEqual(start[0], 0);
+  assert.strictEqual(end[0], source.length);
+
+  for (let i = 1; i < count; i++) {
+    // a node's parent comes before it and covers it
+    assert.ok(parent[i] >= 0 && parent[i] < i);
+    assert.ok(start[parent[i]] <= start[i] && end[i] <= end[parent[i]]);
+    // the first child directly follows its parent
+    if (parent[i] === i - 1) assert.strictEqual(start[i], start[i - 1]);
+    if (nextSibling[i] !== -1) {
+      assert.ok(nextSibling[i] > i);
+      assert.strictEqual(parent[nextSibling[i]], parent[i]);
+      assert.ok(start[nextSibling[i]] >= end[i]);
+    }
+  }
+
+  const fn = kind.indexOf(jass.kinds.function_statement);
+  assert.strictEqual(parent[fn], 0);
+  assert.ok(flags[fn] & NAMED);
+  const name = field.indexOf(jass.fields.name);
+  assert.strictEqual(parent[name], fn);
+  assert.strictEqual(kind[name], jass.kinds.id);
+  assert.strictEqual(source.slice(start[name], end[name]), "Test");
+});
+
+test("exportFlat flags error nodes", { skip }, () => {
+  const { count, flags } = jass.exportFlat("globals\nendglobals\n@@@\n");
+  const { ERROR, MISSING } = jass.flatFlags;
+  assert.ok(flags.slice(0, count).some(f => f & (ERROR | MISSING)));
+  assert.ok(!jass.exportFlat(source).flags.some(f => f & (ERROR | MISSING)));
+});
@@ -0,0 +1,52 @@
+// checkIds: compares the generated id tables (bindings/node/ids.js) with the
+// compiled language, so a table left stale by `tree-sitter generate` fails
+// at load time instead of silently misdispatching tree walkers.
+
+#include <napi.h>
+#include <tree_sitter/api.h>
+
+#include <string>
+
+#include "languages.h"
+
+namespace {
+
+// checkIds(kinds: {[name]: id}, fields: {[name]: id}) -> string[] of mismatches
+Napi::Value CheckIds(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsObject()) {
+        throw Napi::TypeError::New(env, "checkIds: expected kind and field tables");
+    }
+    const TSLanguage *language = tree_sitter_jass();
+    auto mismatches = Napi::Array::New(env);
+    auto report = [&](const std::string &what, const std::string &name, uint32_t expected, uint32_t actual) {
+        mismatches[mismatches.Length()] = Napi::String::New(
+            env, what + " " + name + ": table " + std::to_string(expected) + ", language " + std::to_string(actual));
+    };
+
+    auto kinds = info[0].As<Napi::Object>();
+    auto kind_names = kinds.GetPropertyNames();
+    for (uint32_t i = 0; i < kind_names.Length(); i++) {
+        std::string name = kind_names.Get(i).As<Napi::String>().Utf8Value();
+        uint32_t expected = kinds.Get(name).As<Napi::Number>().Uint32Value();
+        TSSymbol actual = ts_language_symbol_for_name(language, name.data(), name.size(), true);
+        if (actual != expected) report("kind", name, expected, actual);
+    }
+
+    auto fields = info[1].As<Napi::Object>();
+    auto field_names = fields.GetPropertyNames();
+    for (uint32_t i = 0; i < field_names.Length(); i++) {
+        std::string name = field_names.Get(i).As<Napi::String>().Utf8Value();
+        uint32_t expected = fields.Get(name).As<Napi::Number>().Uint32Value();
+        TSFieldId actual = ts_language_field_id_for_name(language, name.data(), name.size());
+        if (actual != expected) report("field", name, expected, actual);
+    }
+
+    return mismatches;
+}
+
+}  // namespace
+
+void InitCheckIds(Napi::Env env, Napi::Object exports) {
+    exports["checkIds"] = Napi::Function::New(env, CheckIds, "checkIds");
+}
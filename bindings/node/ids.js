@@ -0,0 +1,48 @@
+// Generated by script/generate-ids.js from src/parser.c.
+// Do not edit: run `node script/generate-ids.js` after `tree-sitter generate`.
+
+// Node kind ids of the named node types (`node.typeId`).
+exports.kinds = Object.freeze({
+  call_statement: 70,
+  comment: 49,
+  escape_sequence: 51,
+  exitwhen_statement: 67,
+  expr: 64,
+  float: 25,
+  function_arguments: 81,
+  function_call: 80,
+  function_ref: 78,
+  function_statement: 74,
+  globals: 75,
+  id: 59,
+  if_statement: 71,
+  local_statement: 68,
+  loop_statement: 61,
+  native_statement: 72,
+  number: 24,
+  parameter: 77,
+  parameter_list: 76,
+  parens: 79,
+  program: 58,
+  rawcode: 52,
+  return_statement: 66,
+  set_statement: 69,
+  string: 65,
+  type_statement: 73,
+  var_decl: 63,
+  var_stmt: 62,
+});
+
+// Field ids (`cursor.currentFieldId`).
+exports.fields = Object.freeze({
+  args: 1,
+  base: 2,
+  condition: 3,
+  index: 4,
+  name: 5,
+  parameters: 6,
+  return_type: 7,
+  type: 8,
+  value: 9,
+  variable: 10,
+});
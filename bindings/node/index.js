@@ -2,6 +2,18 @@ const root = require("path").join(__dirname, "..", "..");
 
 module.exports = require("node-gyp-build")(root);
 
+const ids = require("./ids");
+module.exports.kinds = ids.kinds;
+module.exports.fields = ids.fields;
+
+if (module.exports.checkIds) {
+  const stale = module.exports.checkIds(ids.kinds, ids.fields);
+  if (stale.length > 0) {
+    throw new Error(`tree-sitter-jass: bindings/node/ids.js does not match the parser (${stale.join("; ")}); ` +
+      "run `node script/generate-ids.js`");
+  }
+}
+
 try {
   module.exports.nodeTypeInfo = require("../../src/node-types.json");
 } catch (_) {}
@@ -0,0 +1,18 @@
+// Grammar variants compiled into this binding, looked up by name.
+
+#ifndef TREE_SITTER_JASS_NODE_LANGUAGES_H_
+#define TREE_SITTER_JASS_NODE_LANGUAGES_H_
+
+#include <tree_sitter/api.h>
+
+#include <string>
+
+extern "C" TSLanguage *tree_sitter_jass();
+
+// Only "jass" until the variants' parsers are committed; nullptr otherwise
+inline const TSLanguage *variant_language(const std::string &variant) {
+    if (variant == "jass") return tree_sitter_jass();
+    return nullptr;
+}
+
+#endif  // TREE_SITTER_JASS_NODE_LANGUAGES_H_
@@ -0,0 +1,128 @@
+// decodeLiterals: every number, float and rawcode of a source, decoded.
+//
+// The source is parsed and bindings/c/literals.c walks the tree once,
+// decoding each literal from the source bytes. The results come back as a
+// struct of arrays in one ArrayBuffer, one entry per literal in source
+// order:
+//
+//   node                  Uint32Array   pre-order index, as in exportFlat
+//   startByte, endByte    Uint32Array   byte range
+//   bits                  Uint32Array   the decoded 32 bits, also viewed as
+//   int                   Int32Array      numbers and rawcodes
+//   real                  Float32Array    floats
+//   kind                  Uint8Array    index into literalKinds
+//   flags                 Uint8Array    literalFlags.OVERFLOW | .UNSIGNED | ...
+//
+// No string is created per literal.
+
+#include <napi.h>
+#include <tree_sitter/api.h>
+
+#include <string>
+#include <vector>
+
+#include "languages.h"
+#include "literals.h"
+
+namespace {
+
+Napi::Object literals_object(Napi::Env env, const std::vector<JassLiteral> &literals) {
+    size_t count = literals.size();
+    auto buffer = Napi::ArrayBuffer::New(env, count * (4 * sizeof(uint32_t) + 2));
+    auto *base = static_cast<uint8_t *>(buffer.Data());
+
+    auto result = Napi::Object::New(env);
+    result["count"] = Napi::Number::New(env, static_cast<double>(count));
+    result["buffer"] = buffer;
+    size_t offset = 0;
+    auto *node = reinterpret_cast<uint32_t *>(base + offset);
+    for (size_t i = 0; i < count; i++) node[i] = literals[i].node_index;
+    result["node"] = Napi::Uint32Array::New(env, count, buffer, offset);
+    offset += count * sizeof(uint32_t);
+    auto *start = reinterpret_cast<uint32_t *>(base + offset);
+    for (size_t i = 0; i < count; i++) start[i] = literals[i].start_byte;
+    result["startByte"] = Napi::Uint32Array::New(env, count, buffer, offset);
+    offset += count * sizeof(uint32_t);
+    auto *end = reinterpret_cast<uint32_t *>(base + offset);
+    for (size_t i = 0; i < count; i++) end[i] = literals[i].end_byte;
+    result["endByte"] = Napi::Uint32Array::New(env, count, buffer, offset);
+    offset += count * sizeof(uint32_t);
+    auto *bits = reinterpret_cast<uint32_t *>(base + offset);
+    for (size_t i = 0; i < count; i++) bits[i] = literals[i].value;
+    result["bits"] = Napi::Uint32Array::New(env, count, buffer, offset);
+    result["int"] = Napi::Int32Array::New(env, count, buffer, offset);
+    result["real"] = Napi::Float32Array::New(env, count, buffer, offset);
+    offset += count * sizeof(uint32_t);
+    result["kind"] = Napi::Uint8Array::New(env, count, buffer, offset);
+    for (size_t i = 0; i < count; i++) base[offset + i] = literals[i].kind;
+    offset += count;
+    result["flags"] = Napi::Uint8Array::New(env, count, buffer, offset);
+    for (size_t i = 0; i < count; i++) base[offset + i] = literals[i].flags;
+    return result;
+}
+
+// decodeLiterals(source: string | Buffer, options?: {variant?: string})
+Napi::Value DecodeLiterals(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    std::string source;
+    if (info.Length() > 0 && info[0].IsString()) {
+        source = info[0].As<Napi::String>().Utf8Value();
+    } else if (info.Length() > 0 && info[0].IsBuffer()) {
+        auto buffer = info[0].As<Napi::Buffer<char>>();
+        source.assign(buffer.Data(), buffer.Length());
+    } else {
+        throw Napi::TypeError::New(env, "decodeLiterals: expected a source string or Buffer");
+    }
+
+    std::string variant = "jass";
+    if (info.Length() > 1 && info[1].IsObject()) {
+        auto options = info[1].As<Napi::Object>();
+        if (options.Has("variant") && options.Get("variant").IsString()) {
+            variant = options.Get("variant").As<Napi::String>().Utf8Value();
+        }
+    }
+    const TSLanguage *language = variant_language(variant);
+    if (!language) {
+        throw Napi::TypeError::New(env, "decodeLiterals: grammar variant '" + variant + "' is not built");
+    }
+
+    TSParser *parser = ts_parser_new();
+    if (!ts_parser_set_language(parser, language)) {
+        ts_parser_delete(parser);
+        throw Napi::Error::New(env, "decodeLiterals: grammar ABI is not supported by the linked tree-sitter runtime");
+    }
+    TSTree *tree = ts_parser_parse_string(parser, nullptr, source.data(), static_cast<uint32_t>(source.size()));
+    ts_parser_delete(parser);
+
+    // A first guess from the source size; denser sources take a second
+    // pass with the exact count
+    TSNode root = ts_tree_root_node(tree);
+    std::vector<JassLiteral> literals(source.size() / 16 + 16);
+    size_t count = jass_literals(root, source.data(), source.size(), literals.data(), literals.size());
+    if (count > literals.size()) {
+        literals.resize(count);
+        jass_literals(root, source.data(), source.size(), literals.data(), literals.size());
+    }
+    literals.resize(count);
+    ts_tree_delete(tree);
+    return literals_object(env, literals);
+}
+
+}  // namespace
+
+void InitLiterals(Napi::Env env, Napi::Object exports) {
+    exports["decodeLiterals"] = Napi::Function::New(env, DecodeLiterals, "decodeLiterals");
+    auto kinds = Napi::Array::New(env, 3);
+    kinds[0u] = Napi::String::New(env, "number");
+    kinds[1u] = Napi::String::New(env, "float");
+    kinds[2u] = Napi::String::New(env, "rawcode");
+    kinds.Freeze();
+    exports["literalKinds"] = kinds;
+    auto flags = Napi::Object::New(env);
+    flags["OVERFLOW"] = Napi::Number::New(env, JASS_LITERAL_OVERFLOW);
+    flags["UNSIGNED"] = Napi::Number::New(env, JASS_LITERAL_UNSIGNED);
+    flags["LONG"] = Napi::Number::New(env, JASS_LITERAL_LONG);
+    flags["INVALID"] = Napi::Number::New(env, JASS_LITERAL_INVALID);
+    flags.Freeze();
+    exports["literalFlags"] = flags;
+}
@@ -0,0 +1,30 @@
+// TSInput over a file mapped by bindings/c/mapped.c.
+
+#ifndef TREE_SITTER_JASS_NODE_MAPPED_INPUT_H_
+#define TREE_SITTER_JASS_NODE_MAPPED_INPUT_H_
+
+#include <tree_sitter/api.h>
+
+#include "mapped.h"
+
+// Each read gets the rest of the mapping from the requested offset: no
+// copy, and no chunk boundary splits a UTF-8 character
+inline const char *read_mapped(void *payload, uint32_t byte, TSPoint, uint32_t *bytes_read) {
+    auto *file = static_cast<const JassMappedFile *>(payload);
+    if (byte >= file->length) {
+        *bytes_read = 0;
+        return "";
+    }
+    *bytes_read = file->length - byte;
+    return file->data + byte;
+}
+
+inline TSInput mapped_input(const JassMappedFile &file) {
+    TSInput input = {};
+    input.payload = const_cast<JassMappedFile *>(&file);
+    input.read = read_mapped;
+    input.encoding = TSInputEncodingUTF8;
+    return input;
+}
+
+#endif  // TREE_SITTER_JASS_NODE_MAPPED_INPUT_H_
@@ -0,0 +1,135 @@
+// outline: the top-level declarations of a source as flat columns.
+//
+// The source is parsed and bindings/c/outline.c walks only the children
+// of the root, never a function body. The entries come back as a struct
+// of arrays in one ArrayBuffer, one entry per declaration in source order:
+//
+//   startByte, endByte        Uint32Array  the declaration (a global's var_decl)
+//   row, column               Uint32Array  its start point
+//   nameStart, nameEnd        Uint32Array  byte range of the name
+//   typeStart, typeEnd        Uint32Array  return type, base or variable type
+//   parametersStart, ...End   Uint32Array  `nothing` or the parameter list
+//   kind                      Uint8Array   index into outlineKinds
+//   flags                     Uint8Array   outlineFlags.CONSTANT | .ARRAY
+//
+// Absent ranges are empty. Names are sliced by the caller, so no string
+// is created per entry.
+
+#include <napi.h>
+#include <tree_sitter/api.h>
+
+#include <string>
+#include <vector>
+
+#include "languages.h"
+#include "outline.h"
+
+namespace {
+
+const char *const RANGE_COLUMNS[] = {
+    "startByte", "endByte",  "row",      "column",          "nameStart",
+    "nameEnd",   "typeStart", "typeEnd", "parametersStart", "parametersEnd",
+};
+constexpr size_t RANGE_COLUMN_COUNT = sizeof(RANGE_COLUMNS) / sizeof(RANGE_COLUMNS[0]);
+
+uint32_t range_value(const JassOutlineEntry &entry, size_t column) {
+    switch (column) {
+        case 0: return entry.start_byte;
+        case 1: return entry.end_byte;
+        case 2: return entry.start_row;
+        case 3: return entry.start_column;
+        case 4: return entry.name_start;
+        case 5: return entry.name_end;
+        case 6: return entry.type_start;
+        case 7: return entry.type_end;
+        case 8: return entry.parameters_start;
+        default: return entry.parameters_end;
+    }
+}
+
+Napi::Object outline_object(Napi::Env env, const std::vector<JassOutlineEntry> &entries) {
+    size_t count = entries.size();
+    auto buffer = Napi::ArrayBuffer::New(env, count * (RANGE_COLUMN_COUNT * sizeof(uint32_t) + 2));
+    auto *base = static_cast<uint8_t *>(buffer.Data());
+
+    auto result = Napi::Object::New(env);
+    result["count"] = Napi::Number::New(env, static_cast<double>(count));
+    result["buffer"] = buffer;
+    size_t offset = 0;
+    for (size_t column = 0; column < RANGE_COLUMN_COUNT; column++) {
+        auto *values = reinterpret_cast<uint32_t *>(base + offset);
+        for (size_t i = 0; i < count; i++) values[i] = range_value(entries[i], column);
+        result[RANGE_COLUMNS[column]] = Napi::Uint32Array::New(env, count, buffer, offset);
+        offset += count * sizeof(uint32_t);
+    }
+    result["kind"] = Napi::Uint8Array::New(env, count, buffer, offset);
+    for (size_t i = 0; i < count; i++) base[offset + i] = entries[i].kind;
+    offset += count;
+    result["flags"] = Napi::Uint8Array::New(env, count, buffer, offset);
+    for (size_t i = 0; i < count; i++) base[offset + i] = entries[i].flags;
+    return result;
+}
+
+// outline(source: string | Buffer, options?: {variant?: string})
+Napi::Value Outline(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    std::string source;
+    if (info.Length() > 0 && info[0].IsString()) {
+        source = info[0].As<Napi::String>().Utf8Value();
+    } else if (info.Length() > 0 && info[0].IsBuffer()) {
+        auto buffer = info[0].As<Napi::Buffer<char>>();
+        source.assign(buffer.Data(), buffer.Length());
+    } else {
+        throw Napi::TypeError::New(env, "outline: expected a source string or Buffer");
+    }
+
+    std::string variant = "jass";
+    if (info.Length() > 1 && info[1].IsObject()) {
+        auto options = info[1].As<Napi::Object>();
+        if (options.Has("variant") && options.Get("variant").IsString()) {
+            variant = options.Get("variant").As<Napi::String>().Utf8Value();
+        }
+    }
+    const TSLanguage *language = variant_language(variant);
+    if (!language) {
+        throw Napi::TypeError::New(env, "outline: grammar variant '" + variant + "' is not built");
+    }
+
+    TSParser *parser = ts_parser_new();
+    if (!ts_parser_set_language(parser, language)) {
+        ts_parser_delete(parser);
+        throw Napi::Error::New(env, "outline: grammar ABI is not supported by the linked tree-sitter runtime");
+    }
+    TSTree *tree = ts_parser_parse_string(parser, nullptr, source.data(), static_cast<uint32_t>(source.size()));
+    ts_parser_delete(parser);
+
+    TSNode root = ts_tree_root_node(tree);
+    // Globals blocks are the only top-level nodes with several entries
+    std::vector<JassOutlineEntry> entries(ts_node_named_child_count(root));
+    size_t count = jass_outline(root, entries.data(), entries.size());
+    if (count > entries.size()) {
+        entries.resize(count);
+        jass_outline(root, entries.data(), entries.size());
+    }
+    entries.resize(count);
+    ts_tree_delete(tree);
+    return outline_object(env, entries);
+}
+
+}  // namespace
+
+void InitOutline(Napi::Env env, Napi::Object exports) {
+    exports["outline"] = Napi::Function::New(env, Outline, "outline");
+    auto kinds = Napi::Array::New(env, 4);
+    kinds[0u] = Napi::String::New(env, "function");
+    kinds[1u] = Napi::String::New(env, "native");
+    kinds[2u] = Napi::String::New(env, "type");
+    kinds[3u] = Napi::String::New(env, "global");
+    kinds.Freeze();
+    exports["outlineKinds"] = kinds;
+    auto flags = Napi::Object::New(env);
+    flags["CONSTANT"] = Napi::Number::New(env, JASS_OUTLINE_CONSTANT);
+    flags["ARRAY"] = Napi::Number::New(env, JASS_OUTLINE_ARRAY);
+    flags.Freeze();
+    exports["outlineFlags"] = flags;
+}
@@ -0,0 +1,50 @@
+// node --test bindings/node/*_test.js (after `npm install` builds the addon)
+
+const assert = require("node:assert");
+const fs = require("node:fs");
+const os = require("node:os");
+const path = require("node:path");
+const { test } = require("node:test");
+
+const jass = require("./index");
+
+// parseFile is only built when the `tree-sitter` runtime is installed
+const skip = !jass.parseFile && "parseFile is not built (install the tree-sitter package)";
+
+const source = "function Test takes nothing returns nothing\nendfunction\n";
+
+function withFile(contents, body) {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), "jass-parse-file-"));
+  const file = path.join(dir, "input.j");
+  fs.writeFileSync(file, contents);
+  return body(file).finally(() => fs.rmSync(dir, { recursive: true, force: true }));
+}
+
+test("parseFile returns the columns exportFlat returns", { skip }, () =>
+  withFile(source, async file => {
+    const flat = await jass.parseFile(file);
+    const expected = jass.exportFlat(source);
+    assert.strictEqual(flat.count, expected.count);
+    for (const name of ["start", "end", "parent", "nextSibling", "kind", "field", "flags"]) {
+      assert.deepStrictEqual(flat[name], expected[name], name);
+    }
+  }));
+
+test("parseFile parses an empty file", { skip }, () =>
+  withFile("", async file => {
+    const flat = await jass.parseFile(file);
+    assert.strictEqual(flat.count, 1);
+    assert.strictEqual(flat.kind[0], jass.kinds.program);
+    assert.strictEqual(flat.end[0], 0);
+  }));
+
+test("parseFile rejects a file that cannot be mapped", { skip }, async () => {
+  const missing = path.join(os.tmpdir(), "jass-parse-file-missing", "nothing.j");
+  await assert.rejects(jass.parseFile(missing), error => error.message.startsWith(`parseFile: cannot read ${missing}: `));
+  // a directory can be opened but not mapped or read
+  await assert.rejects(jass.parseFile(os.tmpdir()), { message: /^parseFile: cannot read / });
+});
+
+test("parseFile rejects a variant that is not built", { skip }, () => {
+  assert.throws(() => jass.parseFile("a.j", { variant: "none" }), { name: "TypeError" });
+});
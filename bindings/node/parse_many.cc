@@ -0,0 +1,315 @@
+// parseMany: parses many JASS sources on the libuv thread pool.
+//
+// Node tooling otherwise parses on the JS main thread, one file at a time.
+// Here each queued AsyncWorker owns one TSParser and pulls the next source
+// from a shared counter until the batch is drained, so large and small files
+// balance across threads. The promise resolves with one compact summary per
+// input, in input order; trees never leave the worker.
+//
+// With `arena` the runtime allocations of each parse come from a per-worker
+// bump arena that is reset after the source (bindings/c/alloc.c); with
+// `countAllocations` every summary also reports the allocator traffic, and
+// with `scannerStats` the scanner counters (JASS_SCANNER_STATS builds).
+// The hooks go into the runtime this addon compiles in (binding.gyp), so
+// parsers created through node-tree-sitter are never affected.
+// Files are memory-mapped and parsed in place (bindings/c/mapped.c).
+
+#include <napi.h>
+#include <tree_sitter/api.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "alloc.h"
+#include "languages.h"
+#include "mapped_input.h"
+#include "scanner_stats.h"
+
+// scanner_stats.cc
+using ScannerStatsFn = bool (*)(JassScannerStats *, bool);
+ScannerStatsFn variant_scanner_stats(const std::string &variant);
+Napi::Object scanner_stats_object(Napi::Env env, const JassScannerStats &stats);
+
+namespace {
+
+struct Source {
+    std::string path;  // empty for Buffer inputs
+    std::string text;
+};
+
+struct Summary {
+    uint32_t bytes = 0;
+    uint32_t nodes = 0;
+    uint32_t errors = 0;  // ERROR and MISSING nodes
+    bool has_first_error = false;
+    TSPoint first_error = {0, 0};
+    double parse_ms = 0;
+    bool counted = false;
+    JassAllocStats allocations = {0, 0, 0};
+    bool scanned = false;
+    JassScannerStats scanner = {};
+    std::string failure;  // set when the file could not be read
+};
+
+struct Batch {
+    Batch(Napi::Env env, const TSLanguage *language)
+        : deferred(Napi::Promise::Deferred::New(env)), language(language) {}
+
+    Napi::Promise::Deferred deferred;
+    const TSLanguage *language;
+    std::vector<Source> sources;
+    std::vector<Summary> summaries;
+    bool arena = false;              // parse each source in a per-worker arena
+    bool count_allocations = false;  // report runtime allocations per source
+    ScannerStatsFn scanner_stats = nullptr;  // report scanner counters per source
+    std::atomic<size_t> next{0};
+    size_t pending_workers = 0;  // main thread only
+    bool settled = false;        // main thread only
+};
+
+void summarize(TSParser *parser, Source &source, Summary &summary) {
+    JassMappedFile file = {};
+    if (!source.path.empty()) {
+        int error = jass_map_file(source.path.c_str(), &file);
+        if (error != 0) {
+            // errno, or GetLastError() on Windows: both are system_category codes
+            summary.failure = "cannot read " + source.path + ": " + std::system_category().message(error);
+            return;
+        }
+        summary.bytes = file.length;
+    } else {
+        summary.bytes = static_cast<uint32_t>(source.text.size());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    TSTree *tree = source.path.empty()
+                       ? ts_parser_parse_string(parser, nullptr, source.text.data(), summary.bytes)
+                       : ts_parser_parse(parser, nullptr, mapped_input(file));
+    summary.parse_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Iterative walk: generated maps can nest deeper than a recursive visitor allows
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        summary.nodes++;
+        if (ts_node_is_error(node) || ts_node_is_missing(node)) {
+            if (!summary.has_first_error) {
+                summary.has_first_error = true;
+                summary.first_error = ts_node_start_point(node);
+            }
+            summary.errors++;
+        }
+        if (ts_tree_cursor_goto_first_child(&cursor) || ts_tree_cursor_goto_next_sibling(&cursor)) {
+            continue;
+        }
+        bool done = true;
+        while (ts_tree_cursor_goto_parent(&cursor)) {
+            if (ts_tree_cursor_goto_next_sibling(&cursor)) {
+                done = false;
+                break;
+            }
+        }
+        if (done) break;
+    }
+    ts_tree_cursor_delete(&cursor);
+    ts_tree_delete(tree);
+
+    // The source is not needed once summarized
+    if (!source.path.empty()) jass_unmap_file(&file);
+    std::string().swap(source.text);
+}
+
+Napi::Array to_array(Napi::Env env, const Batch &batch) {
+    auto results = Napi::Array::New(env, batch.summaries.size());
+    for (size_t i = 0; i < batch.summaries.size(); i++) {
+        const Summary &summary = batch.summaries[i];
+        auto result = Napi::Object::New(env);
+        if (!batch.sources[i].path.empty()) {
+            result["path"] = Napi::String::New(env, batch.sources[i].path);
+        }
+        if (!summary.failure.empty()) {
+            result["error"] = Napi::String::New(env, summary.failure);
+        } else {
+            result["bytes"] = Napi::Number::New(env, summary.bytes);
+            result["nodes"] = Napi::Number::New(env, summary.nodes);
+            result["errors"] = Napi::Number::New(env, summary.errors);
+            if (summary.has_first_error) {
+                auto point = Napi::Object::New(env);
+                point["row"] = Napi::Number::New(env, summary.first_error.row);
+                point["column"] = Napi::Number::New(env, summary.first_error.column);
+                result["firstError"] = point;
+            } else {
+                result["firstError"] = env.Null();
+            }
+            result["parseMs"] = Napi::Number::New(env, summary.parse_ms);
+            if (summary.counted) {
+                auto allocations = Napi::Object::New(env);
+                allocations["calls"] = Napi::Number::New(env, static_cast<double>(summary.allocations.calls));
+                allocations["frees"] = Napi::Number::New(env, static_cast<double>(summary.allocations.frees));
+                allocations["bytes"] = Napi::Number::New(env, static_cast<double>(summary.allocations.bytes));
+                result["allocations"] = allocations;
+            }
+            if (summary.scanned) result["scanner"] = scanner_stats_object(env, summary.scanner);
+        }
+        results[i] = result;
+    }
+    return results;
+}
+
+class ParseWorker : public Napi::AsyncWorker {
+  public:
+    ParseWorker(Napi::Env env, std::shared_ptr<Batch> batch)
+        : Napi::AsyncWorker(env), batch_(std::move(batch)) {}
+
+    void Execute() override {
+        TSParser *parser = ts_parser_new();
+        if (!ts_parser_set_language(parser, batch_->language)) {
+            ts_parser_delete(parser);
+            SetError("parseMany: grammar ABI is not supported by the linked tree-sitter runtime");
+            return;
+        }
+        // In arena mode each source gets a parser created inside the arena,
+        // so parser and tree are gone before the arena is reset
+        JassArena *arena = nullptr;
+        if (batch_->arena) {
+            ts_parser_delete(parser);
+            parser = nullptr;
+            arena = jass_arena_new(1 << 20);
+            if (!arena) {
+                SetError("parseMany: out of memory");
+                return;
+            }
+        }
+
+        for (;;) {
+            size_t i = batch_->next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= batch_->sources.size()) break;
+            Summary &summary = batch_->summaries[i];
+
+            JassAllocStats *previous_stats = nullptr;
+            if (batch_->count_allocations) previous_stats = jass_alloc_count(&summary.allocations);
+            // Counters are per thread: start this source from zero
+            if (batch_->scanner_stats) batch_->scanner_stats(&summary.scanner, true);
+            if (arena) {
+                JassArena *previous = jass_arena_enter(arena);
+                TSParser *scoped = ts_parser_new();
+                ts_parser_set_language(scoped, batch_->language);
+                summarize(scoped, batch_->sources[i], summary);
+                ts_parser_delete(scoped);
+                jass_arena_leave(previous);
+                jass_arena_reset(arena);
+            } else {
+                summarize(parser, batch_->sources[i], summary);
+            }
+            if (batch_->count_allocations) {
+                jass_alloc_count(previous_stats);
+                summary.counted = true;
+            }
+            if (batch_->scanner_stats) summary.scanned = batch_->scanner_stats(&summary.scanner, true);
+        }
+
+        if (parser) ts_parser_delete(parser);
+        jass_arena_delete(arena);
+    }
+
+    void OnOK() override { Finish(); }
+
+    void OnError(const Napi::Error &error) override {
+        if (!batch_->settled) {
+            batch_->settled = true;
+            batch_->deferred.Reject(error.Value());
+        }
+        Finish();
+    }
+
+  private:
+    void Finish() {
+        if (--batch_->pending_workers == 0 && !batch_->settled) {
+            batch_->settled = true;
+            batch_->deferred.Resolve(to_array(Env(), *batch_));
+        }
+    }
+
+    std::shared_ptr<Batch> batch_;
+};
+
+// parseMany(inputs: (string | Buffer)[],
+//           options?: {threads?: number, variant?: string, arena?: boolean,
+//                      countAllocations?: boolean, scannerStats?: boolean})
+// Strings are file paths, read on the worker threads; Buffers are sources.
+Napi::Value ParseMany(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        throw Napi::TypeError::New(env, "parseMany: expected an array of paths or Buffers");
+    }
+    auto inputs = info[0].As<Napi::Array>();
+
+    int64_t threads = std::thread::hardware_concurrency();
+    std::string variant = "jass";
+    bool arena = false;
+    bool count_allocations = false;
+    bool scanner_stats = false;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        auto options = info[1].As<Napi::Object>();
+        if (options.Has("threads") && options.Get("threads").IsNumber()) {
+            threads = options.Get("threads").As<Napi::Number>().Int64Value();
+        }
+        if (options.Has("variant") && options.Get("variant").IsString()) {
+            variant = options.Get("variant").As<Napi::String>().Utf8Value();
+        }
+        arena = options.Has("arena") && options.Get("arena").ToBoolean();
+        count_allocations = options.Has("countAllocations") && options.Get("countAllocations").ToBoolean();
+        scanner_stats = options.Has("scannerStats") && options.Get("scannerStats").ToBoolean();
+    }
+
+    const TSLanguage *language = variant_language(variant);
+    if (!language) {
+        throw Napi::TypeError::New(env, "parseMany: grammar variant '" + variant + "' is not built");
+    }
+
+    auto batch = std::make_shared<Batch>(env, language);
+    batch->arena = arena;
+    batch->count_allocations = count_allocations;
+    if (scanner_stats) batch->scanner_stats = variant_scanner_stats(variant);
+    if (arena || count_allocations) jass_alloc_install();
+    batch->sources.resize(inputs.Length());
+    batch->summaries.resize(inputs.Length());
+    for (uint32_t i = 0; i < inputs.Length(); i++) {
+        Napi::Value input = inputs[i];
+        if (input.IsString()) {
+            batch->sources[i].path = input.As<Napi::String>().Utf8Value();
+        } else if (input.IsBuffer()) {
+            auto buffer = input.As<Napi::Buffer<char>>();
+            batch->sources[i].text.assign(buffer.Data(), buffer.Length());
+        } else {
+            throw Napi::TypeError::New(env, "parseMany: inputs must be paths or Buffers");
+        }
+    }
+
+    Napi::Promise promise = batch->deferred.Promise();
+    if (batch->sources.empty()) {
+        batch->deferred.Resolve(Napi::Array::New(env));
+        return promise;
+    }
+
+    // Concurrency is also capped by the libuv pool (UV_THREADPOOL_SIZE, default 4)
+    size_t workers = threads < 1 ? 1 : static_cast<size_t>(threads);
+    if (workers > batch->sources.size()) workers = batch->sources.size();
+    batch->pending_workers = workers;
+    for (size_t i = 0; i < workers; i++) {
+        (new ParseWorker(env, batch))->Queue();
+    }
+    return promise;
+}
+
+}  // namespace
+
+void InitParseMany(Napi::Env env, Napi::Object exports) {
+    exports["parseMany"] = Napi::Function::New(env, ParseMany, "parseMany");
+}
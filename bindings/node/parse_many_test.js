@@ -0,0 +1,64 @@
+// node --test bindings/node/*_test.js (after `npm install` builds the addon)
+
+const assert = require("node:assert");
+const fs = require("node:fs");
+const os = require("node:os");
+const path = require("node:path");
+const { test } = require("node:test");
+
+const jass = require("./index");
+
+// parseMany is only built when the `tree-sitter` runtime is installed
+const skip = !jass.parseMany && "parseMany is not built (install the tree-sitter package)";
+
+const valid = "function Test takes nothing returns nothing\nendfunction\n";
+const broken = "globals\nendglobals\n@@@\n";
+
+test("parseMany resolves one summary per input, in input order", { skip }, async () => {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), "jass-parse-many-"));
+  try {
+    const inputs = [];
+    for (let i = 0; i < 32; i++) {
+      // sizes differ so the workers finish out of order
+      const file = path.join(dir, `${i}.j`);
+      fs.writeFileSync(file, valid.repeat(i + 1));
+      inputs.push(file);
+    }
+    inputs.push(Buffer.from(valid));
+
+    const results = await jass.parseMany(inputs, { threads: 4 });
+    assert.strictEqual(results.length, inputs.length);
+    for (let i = 0; i < 32; i++) {
+      assert.strictEqual(results[i].path, inputs[i]);
+      assert.strictEqual(results[i].bytes, valid.length * (i + 1));
+      assert.strictEqual(results[i].errors, 0);
+      assert.strictEqual(results[i].firstError, null);
+    }
+    assert.strictEqual(results[32].path, undefined);
+    assert.strictEqual(results[32].bytes, valid.length);
+    assert.strictEqual(results[32].nodes, results[0].nodes);
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+});
+
+test("parseMany reports unreadable files without failing the batch", { skip }, async () => {
+  const missing = path.join(os.tmpdir(), "jass-parse-many-missing", "nothing.j");
+  const results = await jass.parseMany([missing, Buffer.from(valid)]);
+  assert.strictEqual(results[0].path, missing);
+  assert.match(results[0].error, /^cannot read /);
+  assert.strictEqual(results[0].nodes, undefined);
+  assert.strictEqual(results[1].errors, 0);
+});
+
+test("parseMany reports the position of the first error", { skip }, async () => {
+  const [result] = await jass.parseMany([Buffer.from(broken)]);
+  assert.ok(result.errors > 0);
+  assert.strictEqual(result.firstError.row, 2);
+  assert.strictEqual(result.firstError.column, 0);
+});
+
+test("parseMany rejects inputs that are not paths or Buffers", { skip }, () => {
+  assert.throws(() => jass.parseMany("a.j"), { name: "TypeError", message: /expected an array/ });
+  assert.throws(() => jass.parseMany([1]), { name: "TypeError", message: /must be paths or Buffers/ });
+});
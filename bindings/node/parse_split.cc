@@ -0,0 +1,266 @@
+// parseSplit: parses one large JASS source in parallel chunks.
+//
+// The source is cut at top-level declarations by bindings/c/split.c; each
+// queued AsyncWorker owns one TSParser and pulls the next chunk, parsed
+// with the chunk as its only included range so offsets stay those of the
+// whole source. The promise resolves with a summary per chunk and the
+// merged top-level symbols; trees never leave the worker.
+
+#include <napi.h>
+#include <tree_sitter/api.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "languages.h"
+#include "split.h"
+
+static_assert(sizeof(JassChunk) == sizeof(TSRange), "JassChunk mirrors TSRange");
+
+namespace {
+
+struct Symbol {
+    const char *kind;  // "function", "native", "type" or "global"
+    std::string name;
+    uint32_t start_byte;
+    uint32_t end_byte;
+};
+
+struct Chunk {
+    TSRange range;
+    uint32_t nodes = 0;
+    uint32_t errors = 0;  // ERROR and MISSING nodes
+    std::vector<Symbol> symbols;
+};
+
+struct Split {
+    Split(Napi::Env env, const TSLanguage *language)
+        : deferred(Napi::Promise::Deferred::New(env)), language(language) {}
+
+    Napi::Promise::Deferred deferred;
+    const TSLanguage *language;
+    std::string source;
+    bool fell_back = false;
+    std::vector<Chunk> chunks;
+    std::atomic<size_t> next{0};
+    size_t pending_workers = 0;  // main thread only
+    bool settled = false;        // main thread only
+};
+
+void push_symbol(const std::string &source, Chunk &chunk, const char *kind, TSNode node) {
+    TSNode name = ts_node_child_by_field_name(node, "name", 4);
+    if (ts_node_is_null(name)) return;
+    uint32_t start = ts_node_start_byte(name);
+    chunk.symbols.push_back({kind, source.substr(start, ts_node_end_byte(name) - start),
+                             ts_node_start_byte(node), ts_node_end_byte(node)});
+}
+
+void collect_symbols(const std::string &source, Chunk &chunk, TSNode root) {
+    uint32_t count = ts_node_named_child_count(root);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode node = ts_node_named_child(root, i);
+        const char *type = ts_node_type(node);
+        if (std::strcmp(type, "function_statement") == 0) {
+            push_symbol(source, chunk, "function", node);
+        } else if (std::strcmp(type, "native_statement") == 0) {
+            push_symbol(source, chunk, "native", node);
+        } else if (std::strcmp(type, "type_statement") == 0) {
+            push_symbol(source, chunk, "type", node);
+        } else if (std::strcmp(type, "globals") == 0) {
+            uint32_t statements = ts_node_named_child_count(node);
+            for (uint32_t j = 0; j < statements; j++) {
+                TSNode statement = ts_node_named_child(node, j);
+                if (std::strcmp(ts_node_type(statement), "var_stmt") != 0) continue;
+                uint32_t decls = ts_node_named_child_count(statement);
+                for (uint32_t k = 0; k < decls; k++) {
+                    TSNode decl = ts_node_named_child(statement, k);
+                    if (std::strcmp(ts_node_type(decl), "var_decl") == 0) {
+                        push_symbol(source, chunk, "global", decl);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void count_nodes(Chunk &chunk, TSNode root) {
+    // Iterative walk: generated maps can nest deeper than a recursive visitor allows
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        chunk.nodes++;
+        if (ts_node_is_error(node) || ts_node_is_missing(node)) chunk.errors++;
+        if (ts_tree_cursor_goto_first_child(&cursor) || ts_tree_cursor_goto_next_sibling(&cursor)) {
+            continue;
+        }
+        bool done = true;
+        while (ts_tree_cursor_goto_parent(&cursor)) {
+            if (ts_tree_cursor_goto_next_sibling(&cursor)) {
+                done = false;
+                break;
+            }
+        }
+        if (done) break;
+    }
+    ts_tree_cursor_delete(&cursor);
+}
+
+Napi::Object to_object(Napi::Env env, const Split &split) {
+    auto result = Napi::Object::New(env);
+    result["fellBack"] = Napi::Boolean::New(env, split.fell_back);
+    auto chunks = Napi::Array::New(env, split.chunks.size());
+    auto symbols = Napi::Array::New(env);
+    uint32_t symbol_count = 0;
+    for (size_t i = 0; i < split.chunks.size(); i++) {
+        const Chunk &chunk = split.chunks[i];
+        auto object = Napi::Object::New(env);
+        object["startByte"] = Napi::Number::New(env, chunk.range.start_byte);
+        object["endByte"] = Napi::Number::New(env, chunk.range.end_byte);
+        object["startRow"] = Napi::Number::New(env, chunk.range.start_point.row);
+        object["nodes"] = Napi::Number::New(env, chunk.nodes);
+        object["errors"] = Napi::Number::New(env, chunk.errors);
+        chunks[i] = object;
+        for (const Symbol &symbol : chunk.symbols) {
+            auto entry = Napi::Object::New(env);
+            entry["kind"] = Napi::String::New(env, symbol.kind);
+            entry["name"] = Napi::String::New(env, symbol.name);
+            entry["startByte"] = Napi::Number::New(env, symbol.start_byte);
+            entry["endByte"] = Napi::Number::New(env, symbol.end_byte);
+            symbols[symbol_count++] = entry;
+        }
+    }
+    result["chunks"] = chunks;
+    result["symbols"] = symbols;
+    return result;
+}
+
+class SplitWorker : public Napi::AsyncWorker {
+  public:
+    SplitWorker(Napi::Env env, std::shared_ptr<Split> split)
+        : Napi::AsyncWorker(env), split_(std::move(split)) {}
+
+    void Execute() override {
+        TSParser *parser = ts_parser_new();
+        if (!ts_parser_set_language(parser, split_->language)) {
+            ts_parser_delete(parser);
+            SetError("parseSplit: grammar ABI is not supported by the linked tree-sitter runtime");
+            return;
+        }
+        bool whole = split_->chunks.size() == 1;
+        const std::string &source = split_->source;
+        for (;;) {
+            size_t i = split_->next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= split_->chunks.size()) break;
+            Chunk &chunk = split_->chunks[i];
+            if (!whole) ts_parser_set_included_ranges(parser, &chunk.range, 1);
+            TSTree *tree = ts_parser_parse_string(parser, nullptr, source.data(),
+                                                  static_cast<uint32_t>(source.size()));
+            TSNode root = ts_tree_root_node(tree);
+            count_nodes(chunk, root);
+            collect_symbols(source, chunk, root);
+            ts_tree_delete(tree);
+        }
+        ts_parser_delete(parser);
+    }
+
+    void OnOK() override { Finish(); }
+
+    void OnError(const Napi::Error &error) override {
+        if (!split_->settled) {
+            split_->settled = true;
+            split_->deferred.Reject(error.Value());
+        }
+        Finish();
+    }
+
+  private:
+    void Finish() {
+        if (--split_->pending_workers == 0 && !split_->settled) {
+            split_->settled = true;
+            split_->deferred.Resolve(to_object(Env(), *split_));
+        }
+    }
+
+    std::shared_ptr<Split> split_;
+};
+
+// parseSplit(source: string | Buffer,
+//            options?: {threads?: number, chunkSize?: number, variant?: string})
+Napi::Value ParseSplit(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    std::string source;
+    if (info.Length() > 0 && info[0].IsString()) {
+        source = info[0].As<Napi::String>().Utf8Value();
+    } else if (info.Length() > 0 && info[0].IsBuffer()) {
+        auto buffer = info[0].As<Napi::Buffer<char>>();
+        source.assign(buffer.Data(), buffer.Length());
+    } else {
+        throw Napi::TypeError::New(env, "parseSplit: expected a string or Buffer");
+    }
+    if (source.size() > UINT32_MAX) {
+        throw Napi::RangeError::New(env, "parseSplit: sources are limited to 4 GiB");
+    }
+
+    int64_t threads = std::thread::hardware_concurrency();
+    int64_t chunk_size = 0;
+    std::string variant = "jass";
+    if (info.Length() > 1 && info[1].IsObject()) {
+        auto options = info[1].As<Napi::Object>();
+        if (options.Has("threads") && options.Get("threads").IsNumber()) {
+            threads = options.Get("threads").As<Napi::Number>().Int64Value();
+        }
+        if (options.Has("chunkSize") && options.Get("chunkSize").IsNumber()) {
+            chunk_size = options.Get("chunkSize").As<Napi::Number>().Int64Value();
+        }
+        if (options.Has("variant") && options.Get("variant").IsString()) {
+            variant = options.Get("variant").As<Napi::String>().Utf8Value();
+        }
+    }
+    size_t workers = threads < 1 ? 1 : static_cast<size_t>(threads);
+    // Default: about four chunks per worker, none smaller than 64 KiB
+    if (chunk_size < 1) {
+        chunk_size = static_cast<int64_t>(source.size() / (4 * workers));
+        if (chunk_size < (64 << 10)) chunk_size = 64 << 10;
+    }
+
+    const TSLanguage *language = variant_language(variant);
+    if (!language) {
+        throw Napi::TypeError::New(env, "parseSplit: grammar variant '" + variant + "' is not built");
+    }
+
+    auto split = std::make_shared<Split>(env, language);
+    split->source = std::move(source);
+
+    JassChunk *ranges = nullptr;
+    bool ambiguous = false;
+    uint32_t target = chunk_size > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(chunk_size);
+    size_t count = jass_split(split->source.data(), static_cast<uint32_t>(split->source.size()),
+                              target, &ranges, &ambiguous);
+    if (count == 0) throw Napi::Error::New(env, "parseSplit: out of memory");
+    split->fell_back = ambiguous;
+    split->chunks.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        // JassChunk has the field layout of TSRange
+        std::memcpy(&split->chunks[i].range, &ranges[i], sizeof(TSRange));
+    }
+    jass_split_free(ranges);
+
+    Napi::Promise promise = split->deferred.Promise();
+    // Concurrency is also capped by the libuv pool (UV_THREADPOOL_SIZE, default 4)
+    if (workers > count) workers = count;
+    split->pending_workers = workers;
+    for (size_t i = 0; i < workers; i++) {
+        (new SplitWorker(env, split))->Queue();
+    }
+    return promise;
+}
+
+}  // namespace
+
+void InitParseSplit(Napi::Env env, Napi::Object exports) {
+    exports["parseSplit"] = Napi::Function::New(env, ParseSplit, "parseSplit");
+}
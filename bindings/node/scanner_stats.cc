@@ -0,0 +1,81 @@
+// scannerStats: the external scanner counters of common/scanner_stats.h.
+//
+// They exist only when the addon is built with
+// `npm_config_jass_scanner_stats=1`; otherwise scannerStats() returns null.
+// Counters are per thread: the JS thread sees the parses made with
+// node-tree-sitter, parseMany reports its workers' counters per input.
+
+#include <napi.h>
+
+#include <string>
+
+#include "scanner_stats.h"
+
+using ScannerStatsFn = bool (*)(JassScannerStats *, bool);
+
+// Only "jass" until the variants' parsers are committed; nullptr otherwise
+ScannerStatsFn variant_scanner_stats(const std::string &variant) {
+    if (variant == "jass") return tree_sitter_jass_scanner_stats;
+    return nullptr;
+}
+
+// Names of JassScannerStats.tokens, as in the grammar externals
+static const char *const TOKEN_NAMES[JASS_SCANNER_TOKEN_SLOTS] = {
+    "comment",
+    "string_content",
+    "escape_sequence",
+    "rawcode",
+    "id_token",
+    "virtual_endloop",
+    "virtual_endglobals",
+    "virtual_endfunction",
+    "virtual_endif",
+    "function_body",
+};
+
+Napi::Object scanner_stats_object(Napi::Env env, const JassScannerStats &stats) {
+    auto number = [&](uint64_t value) { return Napi::Number::New(env, static_cast<double>(value)); };
+    auto result = Napi::Object::New(env);
+    result["invocations"] = number(stats.invocations);
+    result["errorRecovery"] = number(stats.error_recovery);
+    auto tokens = Napi::Object::New(env);
+    for (size_t i = 0; i < JASS_SCANNER_TOKEN_SLOTS; i++) {
+        tokens[TOKEN_NAMES[i]] = number(stats.tokens[i]);
+    }
+    result["tokens"] = tokens;
+    result["advanced"] = number(stats.advanced);
+    result["skipped"] = number(stats.skipped);
+    result["wordPeeks"] = number(stats.word_peeks);
+    result["keywordMisses"] = number(stats.keyword_misses);
+    return result;
+}
+
+namespace {
+
+// scannerStats(options?: {variant?: string, reset?: boolean})
+Napi::Value ScannerStats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    std::string variant = "jass";
+    bool reset = false;
+    if (info.Length() > 0 && info[0].IsObject()) {
+        auto options = info[0].As<Napi::Object>();
+        if (options.Has("variant") && options.Get("variant").IsString()) {
+            variant = options.Get("variant").As<Napi::String>().Utf8Value();
+        }
+        reset = options.Has("reset") && options.Get("reset").ToBoolean();
+    }
+
+    ScannerStatsFn read = variant_scanner_stats(variant);
+    if (!read) {
+        throw Napi::TypeError::New(env, "scannerStats: grammar variant '" + variant + "' is not built");
+    }
+    JassScannerStats stats;
+    if (!read(&stats, reset)) return env.Null();
+    return scanner_stats_object(env, stats);
+}
+
+}  // namespace
+
+void InitScannerStats(Napi::Env env, Napi::Object exports) {
+    exports["scannerStats"] = Napi::Function::New(env, ScannerStats, "scannerStats");
+}
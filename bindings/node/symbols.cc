@@ -0,0 +1,311 @@
+// loadSymbols: top-level declarations of a file, cached on disk by hash.
+//
+// The source is mapped by bindings/c/mapped.c and hashed; with a cacheDir,
+// an unchanged file's table (bindings/c/symtab.h) is mapped from
+// `<cacheDir>/<hash>.<grammar>.jsym` instead of parsing the source again,
+// where <grammar> is the variant's language name (`jass_chain`). Otherwise
+// the source is parsed, its declarations are serialized, and the table is
+// written under a temporary name and renamed into place, so concurrent
+// loaders never map a partial file.
+
+#include <napi.h>
+#include <tree_sitter/api.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "languages.h"
+#include "mapped.h"
+#include "mapped_input.h"
+#include "symtab.h"
+
+namespace {
+
+struct Declaration {
+    uint8_t kind;
+    uint8_t flags;
+    std::string name;
+    std::string type;
+    std::string parameters;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    uint32_t row;
+    uint32_t column;
+};
+
+const char *const KIND_NAMES[] = {"function", "native", "type", "global"};
+
+void set_text(const JassMappedFile &source, TSNode node, const char **text, uint32_t *length) {
+    if (ts_node_is_null(node)) {
+        *text = nullptr;
+        *length = 0;
+        return;
+    }
+    *text = source.data + ts_node_start_byte(node);
+    *length = ts_node_end_byte(node) - ts_node_start_byte(node);
+}
+
+TSNode field(TSNode node, const char *name) {
+    return ts_node_child_by_field_name(node, name, static_cast<uint32_t>(std::strlen(name)));
+}
+
+bool has_child(TSNode node, const char *type) {
+    uint32_t count = ts_node_child_count(node);
+    for (uint32_t i = 0; i < count; i++) {
+        if (std::strcmp(ts_node_type(ts_node_child(node, i)), type) == 0) return true;
+    }
+    return false;
+}
+
+void push_input(const JassMappedFile &source, std::vector<JassSymbolInput> &inputs, uint8_t kind,
+                uint8_t flags, TSNode node, TSNode name, TSNode type, TSNode parameters) {
+    if (ts_node_is_null(name)) return;
+    JassSymbolInput input = {};
+    input.kind = kind;
+    input.flags = flags;
+    set_text(source, name, &input.name, &input.name_length);
+    set_text(source, type, &input.type, &input.type_length);
+    set_text(source, parameters, &input.parameters, &input.parameters_length);
+    input.start_byte = ts_node_start_byte(node);
+    input.end_byte = ts_node_end_byte(node);
+    TSPoint start = ts_node_start_point(node);
+    input.start_row = start.row;
+    input.start_column = start.column;
+    inputs.push_back(input);
+}
+
+std::vector<JassSymbolInput> collect(const JassMappedFile &source, TSNode root) {
+    std::vector<JassSymbolInput> inputs;
+    TSNode none = {};
+    uint32_t count = ts_node_named_child_count(root);
+    for (uint32_t i = 0; i < count; i++) {
+        TSNode node = ts_node_named_child(root, i);
+        const char *type = ts_node_type(node);
+        bool constant = ts_node_child_count(node) > 0 &&
+                        std::strcmp(ts_node_type(ts_node_child(node, 0)), "constant") == 0;
+        uint8_t flags = constant ? JASS_SYMBOL_CONSTANT : 0;
+        if (std::strcmp(type, "function_statement") == 0) {
+            push_input(source, inputs, JASS_SYMBOL_FUNCTION, flags, node, field(node, "name"),
+                       field(node, "return_type"), field(node, "parameters"));
+        } else if (std::strcmp(type, "native_statement") == 0) {
+            push_input(source, inputs, JASS_SYMBOL_NATIVE, flags, node, field(node, "name"),
+                       field(node, "return_type"), field(node, "parameters"));
+        } else if (std::strcmp(type, "type_statement") == 0) {
+            push_input(source, inputs, JASS_SYMBOL_TYPE, 0, node, field(node, "name"), field(node, "base"),
+                       none);
+        } else if (std::strcmp(type, "globals") == 0) {
+            uint32_t statements = ts_node_named_child_count(node);
+            for (uint32_t j = 0; j < statements; j++) {
+                TSNode statement = ts_node_named_child(node, j);
+                if (std::strcmp(ts_node_type(statement), "var_stmt") != 0) continue;
+                uint8_t global_flags = (has_child(statement, "constant") ? JASS_SYMBOL_CONSTANT : 0) |
+                                       (has_child(statement, "array") ? JASS_SYMBOL_ARRAY : 0);
+                TSNode variable_type = field(statement, "type");
+                uint32_t decls = ts_node_named_child_count(statement);
+                for (uint32_t k = 0; k < decls; k++) {
+                    TSNode decl = ts_node_named_child(statement, k);
+                    if (std::strcmp(ts_node_type(decl), "var_decl") != 0) continue;
+                    push_input(source, inputs, JASS_SYMBOL_GLOBAL, global_flags, decl, field(decl, "name"),
+                               variable_type, none);
+                }
+            }
+        }
+    }
+    return inputs;
+}
+
+std::vector<Declaration> read_table(const JassSymtab &table) {
+    std::vector<Declaration> declarations(table.count);
+    for (uint32_t i = 0; i < table.count; i++) {
+        JassSymbol symbol;
+        jass_symtab_get(&table, i, &symbol);
+        declarations[i] = {symbol.kind,       symbol.flags,    symbol.name,      symbol.type,
+                           symbol.parameters, symbol.start_byte, symbol.end_byte, symbol.start_row,
+                           symbol.start_column};
+    }
+    return declarations;
+}
+
+// Generated languages are named `jass`, `jass_chain`, ...; older ABIs have
+// no name and share one
+const char *grammar_name(const TSLanguage *language) {
+    const char *name = ts_language_name(language);
+    return name ? name : "";
+}
+
+// The table file of `hash`, if it exists and was built from a source of
+// this length with `language`; a missing, stale, corrupt or foreign file
+// is rebuilt
+bool read_cached(const std::string &path, uint64_t hash, uint32_t length, const TSLanguage *language,
+                 std::vector<Declaration> &out) {
+    JassMappedFile file;
+    if (jass_map_file(path.c_str(), &file) != 0) return false;
+    const char *grammar = grammar_name(language);
+    JassSymtab table;
+    bool valid = jass_symtab_open(file.data, file.length, &table) && table.source_hash == hash &&
+                 table.source_length == length && table.abi_version == ts_language_abi_version(language) &&
+                 table.grammar_hash == jass_symtab_hash(grammar, static_cast<uint32_t>(std::strlen(grammar)));
+    if (valid) out = read_table(table);
+    jass_unmap_file(&file);
+    return valid;
+}
+
+std::string store(const std::string &dir, const std::string &path, const uint8_t *data, size_t length) {
+    static std::atomic<uint32_t> next{0};
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::u8path(dir), error);
+    if (error) return "cannot create " + dir + ": " + error.message();
+    std::string temporary = path + "." +
+                            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) +
+                            "-" + std::to_string(next++) + ".tmp";
+    {
+        std::ofstream out(std::filesystem::u8path(temporary), std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(length));
+        if (!out) return "cannot write " + temporary;
+    }
+    // filesystem::rename replaces an existing table on Windows too
+    std::filesystem::rename(std::filesystem::u8path(temporary), std::filesystem::u8path(path), error);
+    if (error) {
+        std::filesystem::remove(std::filesystem::u8path(temporary), error);
+        return "cannot write " + path;
+    }
+    return "";
+}
+
+class LoadSymbolsWorker : public Napi::AsyncWorker {
+  public:
+    LoadSymbolsWorker(Napi::Env env, std::string path, std::string cache_dir, const TSLanguage *language)
+        : Napi::AsyncWorker(env),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          path_(std::move(path)),
+          cache_dir_(std::move(cache_dir)),
+          language_(language) {}
+
+    Napi::Promise Promise() { return deferred_.Promise(); }
+
+    void Execute() override {
+        JassMappedFile source;
+        int error = jass_map_file(path_.c_str(), &source);
+        if (error != 0) {
+            // errno, or GetLastError() on Windows: both are system_category codes
+            SetError("loadSymbols: cannot read " + path_ + ": " + std::system_category().message(error));
+            return;
+        }
+        uint64_t hash = jass_symtab_hash(source.data, source.length);
+        char hex[17];
+        std::snprintf(hex, sizeof hex, "%016llx", static_cast<unsigned long long>(hash));
+        hash_ = hex;
+        std::string table_path =
+            cache_dir_.empty() ? "" : cache_dir_ + "/" + hash_ + "." + grammar_name(language_) + ".jsym";
+        if (!table_path.empty() && read_cached(table_path, hash, source.length, language_, declarations_)) {
+            cached_ = true;
+            jass_unmap_file(&source);
+            return;
+        }
+
+        TSParser *parser = ts_parser_new();
+        if (!ts_parser_set_language(parser, language_)) {
+            ts_parser_delete(parser);
+            jass_unmap_file(&source);
+            SetError("loadSymbols: grammar ABI is not supported by the linked tree-sitter runtime");
+            return;
+        }
+        TSTree *tree = ts_parser_parse(parser, nullptr, mapped_input(source));
+        ts_parser_delete(parser);
+        std::vector<JassSymbolInput> inputs = collect(source, ts_tree_root_node(tree));
+        uint8_t *data = nullptr;
+        size_t length = 0;
+        bool built = jass_symtab_build(hash, source.length, grammar_name(language_),
+                                       ts_language_abi_version(language_), inputs.data(), inputs.size(), &data,
+                                       &length);
+        // The inputs point into the tree's source, so both live until here
+        ts_tree_delete(tree);
+        jass_unmap_file(&source);
+        if (!built) {
+            SetError("loadSymbols: out of memory");
+            return;
+        }
+        JassSymtab table;
+        jass_symtab_open(data, length, &table);
+        declarations_ = read_table(table);
+        std::string failure = table_path.empty() ? "" : store(cache_dir_, table_path, data, length);
+        jass_symtab_free(data);
+        if (!failure.empty()) SetError("loadSymbols: " + failure);
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        auto symbols = Napi::Array::New(env, declarations_.size());
+        for (size_t i = 0; i < declarations_.size(); i++) {
+            const Declaration &declaration = declarations_[i];
+            auto symbol = Napi::Object::New(env);
+            symbol["kind"] = Napi::String::New(env, KIND_NAMES[declaration.kind]);
+            symbol["name"] = Napi::String::New(env, declaration.name);
+            symbol["type"] = Napi::String::New(env, declaration.type);
+            symbol["parameters"] = Napi::String::New(env, declaration.parameters);
+            symbol["constant"] = Napi::Boolean::New(env, declaration.flags & JASS_SYMBOL_CONSTANT);
+            symbol["array"] = Napi::Boolean::New(env, declaration.flags & JASS_SYMBOL_ARRAY);
+            symbol["startByte"] = Napi::Number::New(env, declaration.start_byte);
+            symbol["endByte"] = Napi::Number::New(env, declaration.end_byte);
+            symbol["row"] = Napi::Number::New(env, declaration.row);
+            symbol["column"] = Napi::Number::New(env, declaration.column);
+            symbols[i] = symbol;
+        }
+        auto result = Napi::Object::New(env);
+        result["hash"] = Napi::String::New(env, hash_);
+        result["cached"] = Napi::Boolean::New(env, cached_);
+        result["symbols"] = symbols;
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error &error) override { deferred_.Reject(error.Value()); }
+
+  private:
+    Napi::Promise::Deferred deferred_;
+    std::string path_;
+    std::string cache_dir_;
+    const TSLanguage *language_;
+    std::string hash_;
+    bool cached_ = false;
+    std::vector<Declaration> declarations_;
+};
+
+// loadSymbols(path: string, options?: {cacheDir?: string, variant?: string}): Promise
+Napi::Value LoadSymbols(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        throw Napi::TypeError::New(env, "loadSymbols: expected a path");
+    }
+    std::string cache_dir;
+    std::string variant = "jass";
+    if (info.Length() > 1 && info[1].IsObject()) {
+        auto options = info[1].As<Napi::Object>();
+        if (options.Has("cacheDir") && options.Get("cacheDir").IsString()) {
+            cache_dir = options.Get("cacheDir").As<Napi::String>().Utf8Value();
+        }
+        if (options.Has("variant") && options.Get("variant").IsString()) {
+            variant = options.Get("variant").As<Napi::String>().Utf8Value();
+        }
+    }
+    const TSLanguage *language = variant_language(variant);
+    if (!language) {
+        throw Napi::TypeError::New(env, "loadSymbols: grammar variant '" + variant + "' is not built");
+    }
+    auto *worker = new LoadSymbolsWorker(env, info[0].As<Napi::String>().Utf8Value(), cache_dir, language);
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
+}
+
+}  // namespace
+
+void InitSymbols(Napi::Env env, Napi::Object exports) {
+    exports["loadSymbols"] = Napi::Function::New(env, LoadSymbols, "loadSymbols");
+}
@@ -0,0 +1,161 @@
+//! Arena allocation and allocation counting for parses (feature `arena`).
+//!
+//! Installs the allocator hooks of `bindings/c/alloc.c` into the tree-sitter
+//! runtime. A [`ParseArena`] runs a parse with every runtime allocation of
+//! the thread bump-allocated from one arena. Dropping the tree then frees
+//! no blocks one by one; the whole arena is reset at once when the parse is
+//! done. [`count_allocations`] reports the allocator traffic of any closure.
+//!
+//! ```
+//! let mut arena = tree_sitter_jass::ParseArena::new();
+//! let functions = arena.parse(
+//!     &tree_sitter_jass::language().into(),
+//!     b"function F takes nothing returns nothing\nendfunction\n",
+//!     |root| root.named_child_count(),
+//! );
+//! assert_eq!(functions, 1);
+//! ```
+
+use std::ffi::c_void;
+use std::sync::Once;
+
+use tree_sitter::{Language, Node, Parser};
+
+#[repr(C)]
+struct RawArena(c_void);
+
+/// Allocator traffic counted by [`count_allocations`].
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct AllocStats {
+    /// malloc, calloc and realloc calls
+    pub calls: u64,
+    /// free calls, including no-op frees of arena blocks
+    pub frees: u64,
+    /// bytes requested by those calls
+    pub bytes: u64,
+}
+
+unsafe extern "C" {
+    fn jass_alloc_install();
+    fn jass_arena_new(chunk_size: usize) -> *mut RawArena;
+    fn jass_arena_delete(arena: *mut RawArena);
+    fn jass_arena_enter(arena: *mut RawArena) -> *mut RawArena;
+    fn jass_arena_leave(previous: *mut RawArena);
+    fn jass_arena_reset(arena: *mut RawArena);
+    fn jass_arena_used(arena: *const RawArena) -> usize;
+    fn jass_alloc_count(stats: *mut AllocStats) -> *mut AllocStats;
+}
+
+fn install() {
+    static INSTALL: Once = Once::new();
+    // The hooks fall back to the system allocator outside arena scopes, so
+    // parsers that already exist keep working.
+    INSTALL.call_once(|| unsafe { jass_alloc_install() });
+}
+
+/// A bump arena for the runtime allocations of one parse at a time.
+///
+/// Not `Sync`: an arena is entered on the thread that runs the parse.
+pub struct ParseArena {
+    raw: *mut RawArena,
+    last_used: usize,
+}
+
+// Only ever entered by the thread holding `&mut self`
+unsafe impl Send for ParseArena {}
+
+impl ParseArena {
+    /// An arena whose first chunk is 1 MiB; later chunks double.
+    pub fn new() -> Self {
+        Self::with_chunk_size(1 << 20)
+    }
+
+    pub fn with_chunk_size(bytes: usize) -> Self {
+        install();
+        let raw = unsafe { jass_arena_new(bytes) };
+        assert!(!raw.is_null(), "out of memory");
+        Self { raw, last_used: 0 }
+    }
+
+    /// Parses `source` with a parser created inside the arena and passes the
+    /// root node to `f`. Parser and tree are dropped before the arena is
+    /// reset, and `f` can't keep the node, so nothing outlives the arena.
+    pub fn parse<R>(
+        &mut self,
+        language: &Language,
+        source: &[u8],
+        f: impl for<'tree> FnOnce(Node<'tree>) -> R,
+    ) -> R {
+        // Declared first so it is dropped last, after parser and tree,
+        // even when `f` panics
+        let _scope = Scope::enter(self.raw);
+        let mut parser = Parser::new();
+        parser
+            .set_language(language)
+            .expect("Error loading JASS grammar");
+        let tree = parser
+            .parse(source, None)
+            .expect("parser has a language and no cancellation");
+        let result = f(tree.root_node());
+        drop(tree);
+        drop(parser);
+        self.last_used = unsafe { jass_arena_used(self.raw) };
+        result
+    }
+
+    /// Arena bytes the last parse took, including block headers.
+    pub fn used(&self) -> usize {
+        self.last_used
+    }
+}
+
+impl Default for ParseArena {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl Drop for ParseArena {
+    fn drop(&mut self) {
+        unsafe { jass_arena_delete(self.raw) }
+    }
+}
+
+struct Scope {
+    arena: *mut RawArena,
+    previous: *mut RawArena,
+}
+
+impl Scope {
+    fn enter(arena: *mut RawArena) -> Self {
+        let previous = unsafe { jass_arena_enter(arena) };
+        Self { arena, previous }
+    }
+}
+
+impl Drop for Scope {
+    fn drop(&mut self) {
+        unsafe {
+            jass_arena_leave(self.previous);
+            jass_arena_reset(self.arena);
+        }
+    }
+}
+
+/// Runs `f` and returns the tree-sitter runtime allocations it made on
+/// this thread, with or without an arena.
+pub fn count_allocations<R>(f: impl FnOnce() -> R) -> (R, AllocStats) {
+    install();
+    let mut stats = AllocStats::default();
+    struct Restore(*mut AllocStats);
+    impl Drop for Restore {
+        fn drop(&mut self) {
+            unsafe { jass_alloc_count(self.0) };
+        }
+    }
+    let restore = Restore(unsafe { jass_alloc_count(&mut stats) });
+    let result = f();
+    drop(restore);
+    (result, stats)
+}
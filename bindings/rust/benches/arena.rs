@@ -0,0 +1,78 @@
+//! Arena allocation benchmark.
+//!
+//! For each corpus input, compares a parse plus tree drop on the system
+//! allocator with the same parse in a `ParseArena`, and reports the runtime
+//! allocations per parse from `count_allocations`.
+//!
+//! ```sh
+//! cargo bench --bench arena --features arena
+//! ```
+
+mod corpus;
+
+use std::time::{Duration, Instant};
+
+use tree_sitter::{Language, Parser};
+use tree_sitter_jass::{ParseArena, count_allocations};
+
+const MIN_TIME: Duration = Duration::from_millis(500);
+const MAX_ITERATIONS: usize = 10_000;
+
+/// Average time of `f` over at least MIN_TIME.
+fn time(mut f: impl FnMut()) -> Duration {
+    let mut iterations = 0;
+    let start = Instant::now();
+    while start.elapsed() < MIN_TIME && iterations < MAX_ITERATIONS {
+        f();
+        iterations += 1;
+    }
+    start.elapsed() / iterations as u32
+}
+
+fn main() {
+    let filter: Vec<String> = std::env::args()
+        .skip(1)
+        .filter(|arg| !arg.starts_with("--"))
+        .collect();
+    let mut inputs = corpus::load();
+    inputs.retain(|input| filter.is_empty() || filter.iter().any(|f| input.name.contains(f)));
+    inputs.sort_by_key(|input| input.source.len());
+
+    let language: Language = tree_sitter_jass::language().into();
+    let mut arena = ParseArena::new();
+
+    println!(
+        "{:<32} {:>10} {:>12} {:>12} {:>8} {:>10} {:>12} {:>12}",
+        "input", "bytes", "system", "arena", "speedup", "calls", "alloc bytes", "arena bytes"
+    );
+    for input in &inputs {
+        let source = input.source.as_bytes();
+
+        // Includes parser creation, as the arena parse does
+        let system = time(|| {
+            let mut parser = Parser::new();
+            parser.set_language(&language).unwrap();
+            drop(parser.parse(source, None).unwrap());
+        });
+        let arena_time = time(|| arena.parse(&language, source, |_| ()));
+
+        let ((), stats) = count_allocations(|| {
+            let mut parser = Parser::new();
+            parser.set_language(&language).unwrap();
+            drop(parser.parse(source, None).unwrap());
+        });
+        arena.parse(&language, source, |_| ());
+
+        println!(
+            "{:<32} {:>10} {:>10.2}ms {:>10.2}ms {:>7.2}x {:>10} {:>12} {:>12}",
+            input.name,
+            source.len(),
+            system.as_secs_f64() * 1e3,
+            arena_time.as_secs_f64() * 1e3,
+            system.as_secs_f64() / arena_time.as_secs_f64(),
+            stats.calls,
+            stats.bytes,
+            arena.used()
+        );
+    }
+}
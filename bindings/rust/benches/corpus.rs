@@ -0,0 +1,299 @@
+//! Deterministic benchmark corpus.
+//!
+//! Generated maps imitate the shape of extracted `war3map.j` files: one big
+//! `globals` block, a handful of natives and types, then many generated
+//! trigger functions with locals, loops, ifs, calls, strings, rawcodes and
+//! comments. The generator is seeded, so the same size always produces the
+//! same bytes and numbers stay comparable between runs.
+
+#![allow(dead_code)]
+
+use std::fmt::Write;
+use std::path::{Path, PathBuf};
+
+/// One named benchmark input.
+pub struct Input {
+    pub name: String,
+    pub source: String,
+}
+
+/// Sizes of the generated maps, in bytes (approximate, never smaller).
+pub const GENERATED_SIZES: &[(&str, usize)] = &[
+    ("map-1k", 1 << 10),
+    ("map-100k", 100 << 10),
+    ("map-5m", 5 << 20),
+];
+
+/// Environment variable pointing at a directory of real `.j` files
+/// (`common.j`, `Blizzard.j`, extracted maps) to add to the corpus.
+pub const CORPUS_DIR_ENV: &str = "JASS_BENCH_CORPUS";
+
+/// The fixed corpus: the repository examples, the generated maps and every
+/// `.j`/`.jass` file under `$JASS_BENCH_CORPUS`, if set.
+pub fn load() -> Vec<Input> {
+    let root = Path::new(env!("CARGO_MANIFEST_DIR"));
+    let mut inputs = Vec::new();
+
+    for name in ["examples/example.jass", "examples/test.jass"] {
+        if let Ok(source) = std::fs::read_to_string(root.join(name)) {
+            inputs.push(Input {
+                name: name.to_string(),
+                source,
+            });
+        }
+    }
+
+    for &(name, size) in GENERATED_SIZES {
+        inputs.push(Input {
+            name: name.to_string(),
+            source: generate_map(size),
+        });
+    }
+
+    if let Some(dir) = std::env::var_os(CORPUS_DIR_ENV) {
+        for path in jass_files(Path::new(&dir)) {
+            // Map dumps are frequently not valid UTF-8; the parser only
+            // cares about bytes, so decode lossily.
+            if let Ok(bytes) = std::fs::read(&path) {
+                inputs.push(Input {
+                    name: path.display().to_string(),
+                    source: String::from_utf8_lossy(&bytes).into_owned(),
+                });
+            }
+        }
+    }
+
+    inputs
+}
+
+/// Every `.j` / `.jass` file below `dir`, sorted for stable output.
+pub fn jass_files(dir: &Path) -> Vec<PathBuf> {
+    let mut files = Vec::new();
+    let mut stack = vec![dir.to_path_buf()];
+    while let Some(dir) = stack.pop() {
+        let Ok(entries) = std::fs::read_dir(&dir) else {
+            continue;
+        };
+        for entry in entries.flatten() {
+            let path = entry.path();
+            if path.is_dir() {
+                stack.push(path);
+            } else if matches!(
+                path.extension().and_then(|e| e.to_str()),
+                Some("j" | "jass")
+            ) {
+                files.push(path);
+            }
+        }
+    }
+    files.sort();
+    files
+}
+
+/// Small xorshift generator; good enough to vary the generated code and
+/// keeps the benchmark free of extra dependencies.
+pub struct Rng(u64);
+
+impl Rng {
+    pub fn new(seed: u64) -> Self {
+        Self(seed | 1)
+    }
+
+    pub fn next(&mut self) -> u64 {
+        let mut x = self.0;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        self.0 = x;
+        x
+    }
+
+    pub fn below(&mut self, n: usize) -> usize {
+        (self.next() % n as u64) as usize
+    }
+
+    pub fn pick<'a>(&mut self, items: &[&'a str]) -> &'a str {
+        items[self.below(items.len())]
+    }
+}
+
+const TYPES: &[&str] = &["integer", "real", "boolean", "string", "unit", "timer", "group"];
+const NATIVES: &[&str] = &[
+    "GetTriggerUnit",
+    "GetUnitX",
+    "GetUnitY",
+    "CreateGroup",
+    "DestroyGroup",
+    "TimerStart",
+    "I2S",
+    "R2I",
+    "BJDebugMsg",
+];
+const RAWCODES: &[&str] = &["'hfoo'", "'Hpal'", "'A000'", "'I00B'", "'h'"];
+
+/// Generates a map of at least `target` bytes.
+pub fn generate_map(target: usize) -> String {
+    let mut rng = Rng::new(0x4a41_5353 ^ target as u64);
+    let mut out = String::with_capacity(target + 4096);
+
+    out.push_str("//===========================================================================\n");
+    out.push_str("// Generated benchmark map\n");
+    out.push_str("//===========================================================================\n");
+    out.push_str("type agent extends handle\ntype unit extends agent\n");
+    out.push_str("native GetUnitX takes unit whichUnit returns real\n");
+    out.push_str("constant native GetTriggerUnit takes nothing returns unit\n\n");
+
+    let globals = 8 + target / 2048;
+    out.push_str("globals\n");
+    for i in 0..globals {
+        let ty = rng.pick(TYPES);
+        match rng.below(4) {
+            0 => writeln!(out, "    {ty} array udg_{ty}_{i}").unwrap(),
+            1 => writeln!(out, "    constant integer udg_Const_{i} = {}", rng.below(100_000)).unwrap(),
+            _ => writeln!(out, "    {ty} udg_{ty}_{i}").unwrap(),
+        }
+    }
+    out.push_str("endglobals\n\n");
+
+    let mut n = 0;
+    while out.len() < target {
+        write_function(&mut out, &mut rng, n);
+        n += 1;
+    }
+    out
+}
+
+fn write_function(out: &mut String, rng: &mut Rng, n: usize) {
+    writeln!(out, "//===========================================================================").unwrap();
+    writeln!(out, "// Trigger: gg_trg_Generated_{n}").unwrap();
+    writeln!(
+        out,
+        "function Trig_Generated_{n}_Actions takes integer a, real b returns nothing"
+    )
+    .unwrap();
+    out.push_str("    local integer i = 0\n");
+    out.push_str("    local unit u = GetTriggerUnit()\n");
+    writeln!(out, "    local string s = \"Generated \\\"{n}\\\"\\n\"").unwrap();
+
+    for _ in 0..1 + rng.below(4) {
+        write_statement(out, rng, 1, n);
+    }
+
+    out.push_str("    loop\n");
+    writeln!(out, "        exitwhen i >= {}", 1 + rng.below(12)).unwrap();
+    for _ in 0..1 + rng.below(3) {
+        write_statement(out, rng, 2, n);
+    }
+    out.push_str("        set i = i + 1\n");
+    out.push_str("    endloop\n");
+    out.push_str("    set u = null\n");
+    out.push_str("endfunction\n\n");
+}
+
+fn write_statement(out: &mut String, rng: &mut Rng, depth: usize, n: usize) {
+    let indent = "    ".repeat(depth);
+    match rng.below(6) {
+        0 => {
+            writeln!(out, "{indent}if {} then", condition(rng)).unwrap();
+            if depth < 4 {
+                write_statement(out, rng, depth + 1, n);
+            }
+            if rng.below(2) == 0 {
+                writeln!(out, "{indent}else").unwrap();
+                writeln!(out, "{indent}    call BJDebugMsg(I2S({}))", rng.below(1000)).unwrap();
+            }
+            writeln!(out, "{indent}endif").unwrap();
+        }
+        1 => writeln!(
+            out,
+            "{indent}set udg_integer_{} = {} + a * ({} - R2I(b))",
+            rng.below(8),
+            rng.pick(RAWCODES),
+            rng.below(1 << 20)
+        )
+        .unwrap(),
+        2 => writeln!(out, "{indent}// {} generated comment", rng.next()).unwrap(),
+        3 => writeln!(
+            out,
+            "{indent}call TimerStart(CreateTimer(), {}.{}, false, function Trig_Generated_{n}_Actions)",
+            rng.below(10),
+            rng.below(100)
+        )
+        .unwrap(),
+        4 => writeln!(
+            out,
+            "{indent}set udg_real_{}[i] = GetUnitX(u) * {}.5 - 0x{:X}",
+            rng.below(8),
+            rng.below(64),
+            rng.below(0xFFFF)
+        )
+        .unwrap(),
+        _ => writeln!(out, "{indent}call {}(u)", rng.pick(NATIVES)).unwrap(),
+    }
+}
+
+fn condition(rng: &mut Rng) -> String {
+    match rng.below(3) {
+        0 => format!("i == {} or a != {}", rng.below(10), rng.below(10)),
+        1 => format!("GetUnitX(u) > {}.0 and not (b < 0.)", rng.below(2048)),
+        _ => format!("u != null and s == \"{}\"", rng.below(100)),
+    }
+}
+
+/// Adversarial inputs for the scaling benchmark, each built from `n`
+/// repetitions of one malformed pattern.
+pub const ADVERSARIAL: &[(&str, fn(usize) -> String)] = &[
+    ("nested-if", nested_if),
+    ("nested-loop", nested_loop),
+    ("stray-closers", stray_closers),
+    ("unterminated-literals", unterminated_literals),
+    ("open-parens", open_parens),
+    ("unclosed-functions", unclosed_functions),
+];
+
+/// `n` nested `if ... then` without any `endif`, in an unclosed function.
+pub fn nested_if(n: usize) -> String {
+    let mut out = String::from("function F takes nothing returns nothing\n");
+    for i in 0..n {
+        writeln!(out, "if x{i} then").unwrap();
+    }
+    out
+}
+
+/// `n` nested `loop` without `endloop`, each with one statement.
+pub fn nested_loop(n: usize) -> String {
+    let mut out = String::from("function F takes nothing returns nothing\n");
+    for i in 0..n {
+        writeln!(out, "loop\nset i = {i}").unwrap();
+    }
+    out
+}
+
+/// Closers with nothing to close.
+pub fn stray_closers(n: usize) -> String {
+    "endif\nendloop\nendfunction\nendglobals\nelse\n".repeat(n)
+}
+
+/// Alternating unterminated strings and rawcodes inside one function.
+pub fn unterminated_literals(n: usize) -> String {
+    let mut out = String::from("function F takes nothing returns nothing\n");
+    for _ in 0..n {
+        out.push_str("set s = \"abc\nset r = 'ab\ncall X('\")\n");
+    }
+    out
+}
+
+/// One expression with `n` unclosed parentheses.
+pub fn open_parens(n: usize) -> String {
+    format!("globals\ninteger x = {}1\nendglobals\n", "(".repeat(n))
+}
+
+/// `n` function headers without bodies or `endfunction`.
+pub fn unclosed_functions(n: usize) -> String {
+    let mut out = String::new();
+    for i in 0..n {
+        writeln!(out, "function F{i} takes nothing returns nothing\nset x = {i}").unwrap();
+    }
+    out
+}
+
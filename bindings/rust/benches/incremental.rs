@@ -0,0 +1,234 @@
+//! Incremental reparse latency benchmark.
+//!
+//! Replays keystroke sessions against large maps: every keystroke edits the
+//! source, is applied to the old tree with `Tree::edit` and reparsed with the
+//! old tree. Per session it reports the p50/p99/max reparse latency, the
+//! bytes covered by `Tree::changed_ranges` and the bytes the parser read
+//! back from the source.
+//!
+//! ```sh
+//! cargo bench --bench incremental
+//! JASS_BENCH_CORPUS=path/to/maps cargo bench --bench incremental
+//! ```
+//!
+//! The sessions are recorded against the middle of the map:
+//!
+//! - `type-in-function` types a call statement into a function body,
+//! - `delete-endif` backspaces over an `endif` and types it again, which
+//!   leaves the `if` unclosed for a few keystrokes,
+//! - `insert-loop` types `loop`, its body and `endloop`, so the new loop is
+//!   closed by a virtual `endloop` until the last line is typed.
+//!
+//! "changed" and "read" are means per keystroke. "read" counts the source
+//! bytes handed to the parser in `READ_CHUNK`-sized pieces, an upper bound of
+//! what was re-lexed: reused subtrees are never read.
+
+mod corpus;
+
+use std::time::{Duration, Instant};
+
+use tree_sitter::{InputEdit, Parser, Point, Tree};
+
+/// Size of the generated map, about 50k lines.
+const GENERATED_SIZE: usize = 2 << 20;
+/// The input callback returns at most this many bytes per call.
+const READ_CHUNK: usize = 64;
+/// Maps smaller than this from `$JASS_BENCH_CORPUS` are skipped.
+const MIN_CORPUS_SIZE: usize = 256 << 10;
+
+enum Key {
+    Type(u8),
+    Backspace,
+}
+
+fn typed(text: &str) -> impl Iterator<Item = Key> + '_ {
+    text.bytes().map(Key::Type)
+}
+
+fn backspaces(n: usize) -> impl Iterator<Item = Key> {
+    (0..n).map(|_| Key::Backspace)
+}
+
+struct Session {
+    name: &'static str,
+    /// Byte offset the first keystroke applies to
+    cursor: usize,
+    keys: Vec<Key>,
+}
+
+/// Start of the line after the first `needle` past the middle of `source`.
+fn line_after(source: &str, needle: &str) -> Option<usize> {
+    let middle = source.len() / 2;
+    let found = middle + source[middle..].find(needle)?;
+    Some(found + source[found..].find('\n')? + 1)
+}
+
+fn sessions(source: &str) -> Vec<Session> {
+    let mut sessions = Vec::new();
+    if let Some(cursor) = line_after(source, "    local string s = ") {
+        sessions.push(Session {
+            name: "type-in-function",
+            cursor,
+            keys: typed("    call BJDebugMsg(\"typed\")\n").collect(),
+        });
+        sessions.push(Session {
+            name: "insert-loop",
+            cursor,
+            keys: typed("    loop\n        exitwhen i > 3\n        set i = i + 1\n    endloop\n").collect(),
+        });
+    }
+    let middle = source.len() / 2;
+    if let Some(found) = source[middle..].find("endif\n") {
+        sessions.push(Session {
+            name: "delete-endif",
+            cursor: middle + found + "endif".len(),
+            keys: backspaces(5).chain(typed("endif")).collect(),
+        });
+    }
+    sessions
+}
+
+fn point_at(source: &[u8], offset: usize) -> Point {
+    let before = &source[..offset];
+    let row = before.iter().filter(|&&b| b == b'\n').count();
+    let column = offset - before.iter().rposition(|&b| b == b'\n').map_or(0, |i| i + 1);
+    Point::new(row, column)
+}
+
+/// Applies one keystroke at `cursor`; returns the edit and the new cursor.
+fn apply(source: &mut Vec<u8>, cursor: usize, key: &Key) -> (InputEdit, usize) {
+    let start_position = point_at(source, match key {
+        Key::Type(_) => cursor,
+        Key::Backspace => cursor - 1,
+    });
+    match *key {
+        Key::Type(byte) => {
+            source.insert(cursor, byte);
+            let edit = InputEdit {
+                start_byte: cursor,
+                old_end_byte: cursor,
+                new_end_byte: cursor + 1,
+                start_position,
+                old_end_position: start_position,
+                new_end_position: point_at(source, cursor + 1),
+            };
+            (edit, cursor + 1)
+        }
+        Key::Backspace => {
+            let old_end_position = point_at(source, cursor);
+            source.remove(cursor - 1);
+            let edit = InputEdit {
+                start_byte: cursor - 1,
+                old_end_byte: cursor,
+                new_end_byte: cursor - 1,
+                start_position,
+                old_end_position,
+                new_end_position: start_position,
+            };
+            (edit, cursor - 1)
+        }
+    }
+}
+
+/// Parses with `old_tree`, counting the bytes read from `source`.
+fn reparse(parser: &mut Parser, source: &[u8], old_tree: Option<&Tree>) -> (Tree, usize) {
+    let mut read = 0;
+    let tree = parser
+        .parse_with_options(
+            &mut |offset, _| {
+                let chunk = &source[offset.min(source.len())..(offset + READ_CHUNK).min(source.len())];
+                read += chunk.len();
+                chunk
+            },
+            old_tree,
+            None,
+        )
+        .unwrap();
+    (tree, read)
+}
+
+fn percentile(sorted: &[Duration], p: f64) -> Duration {
+    let rank = ((sorted.len() as f64 * p).ceil() as usize).clamp(1, sorted.len());
+    sorted[rank - 1]
+}
+
+fn inputs() -> Vec<corpus::Input> {
+    let mut inputs = vec![corpus::Input {
+        name: format!("map-{}m", GENERATED_SIZE >> 20),
+        source: corpus::generate_map(GENERATED_SIZE),
+    }];
+    inputs.extend(
+        corpus::load()
+            .into_iter()
+            .filter(|input| !input.name.starts_with("map-") && input.source.len() >= MIN_CORPUS_SIZE),
+    );
+    inputs
+}
+
+fn main() {
+    let mut parser = Parser::new();
+    parser
+        .set_language(&tree_sitter_jass::language().into())
+        .expect("Error loading JASS grammar");
+
+    println!(
+        "{:<32} {:<18} {:>6} {:>10} {:>10} {:>10} {:>12} {:>10} {:>10}",
+        "input", "session", "keys", "p50", "p99", "max", "changed", "read", "read max"
+    );
+
+    for input in inputs() {
+        let lines = input.source.lines().count();
+        let start = Instant::now();
+        let (base_tree, _) = reparse(&mut parser, input.source.as_bytes(), None);
+        println!(
+            "{:<32} {:<18} {:>6} {:>9.3}ms   ({} lines, full parse)",
+            input.name,
+            "-",
+            "-",
+            start.elapsed().as_secs_f64() * 1e3,
+            lines
+        );
+
+        for session in sessions(&input.source) {
+            let mut source = input.source.clone().into_bytes();
+            let mut tree = base_tree.clone();
+            let mut cursor = session.cursor;
+            let mut latencies = Vec::with_capacity(session.keys.len());
+            let (mut changed, mut read, mut read_max) = (0, 0, 0);
+
+            for key in &session.keys {
+                let edit;
+                (edit, cursor) = apply(&mut source, cursor, key);
+                tree.edit(&edit);
+
+                let start = Instant::now();
+                let (new_tree, bytes) = reparse(&mut parser, &source, Some(&tree));
+                latencies.push(start.elapsed());
+
+                changed += tree
+                    .changed_ranges(&new_tree)
+                    .map(|range| range.end_byte - range.start_byte)
+                    .sum::<usize>();
+                read += bytes;
+                read_max = read_max.max(bytes);
+                tree = new_tree;
+            }
+
+            latencies.sort();
+            let keys = latencies.len();
+            let ms = |d: Duration| format!("{:.3}ms", d.as_secs_f64() * 1e3);
+            println!(
+                "{:<32} {:<18} {:>6} {:>10} {:>10} {:>10} {:>12} {:>10} {:>10}",
+                input.name,
+                session.name,
+                keys,
+                ms(percentile(&latencies, 0.50)),
+                ms(percentile(&latencies, 0.99)),
+                ms(*latencies.last().unwrap()),
+                changed / keys,
+                read / keys,
+                read_max
+            );
+        }
+    }
+}
@@ -0,0 +1,202 @@
+//! Parser throughput benchmark.
+//!
+//! Runs `tree_sitter_jass()` over the corpus from `corpus.rs` and reports,
+//! per input: MB/s, ns per token, node count and peak RSS.
+//!
+//! ```sh
+//! cargo bench --bench parse
+//! JASS_BENCH_CORPUS=path/to/maps cargo bench --bench parse
+//! ```
+//!
+//! A token here is a leaf of the syntax tree (keywords, punctuation,
+//! identifiers, literals and comments). Peak RSS is the process high-water
+//! mark after the input was benchmarked, so inputs run in ascending size.
+//!
+//! GLR activity is measured in one extra, untimed parse with the debug log
+//! enabled: "max stacks" is the largest number of parse stack versions alive
+//! at once and "forked" the share of parser steps taken while more than one
+//! version existed.
+
+mod corpus;
+
+use std::sync::Arc;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+
+use tree_sitter::{LogType, Parser, Tree};
+use tree_sitter_language::LanguageFn;
+
+/// Minimum wall time spent on each input.
+const MIN_TIME: Duration = Duration::from_millis(500);
+/// Iterations are capped so tiny inputs don't run forever.
+const MAX_ITERATIONS: usize = 10_000;
+
+/// The grammars to benchmark. Only the default one has a committed parser;
+/// the variants join once theirs are generated.
+pub fn grammars() -> Vec<(&'static str, LanguageFn)> {
+    vec![("jass", tree_sitter_jass::language())]
+}
+
+/// Node and token (leaf) counts of a tree, walked with a cursor so deep
+/// trees don't recurse.
+pub struct TreeStats {
+    pub nodes: usize,
+    pub tokens: usize,
+    pub errors: usize,
+}
+
+pub fn tree_stats(tree: &Tree) -> TreeStats {
+    let mut stats = TreeStats {
+        nodes: 0,
+        tokens: 0,
+        errors: 0,
+    };
+    let mut cursor = tree.walk();
+    loop {
+        let node = cursor.node();
+        stats.nodes += 1;
+        if node.child_count() == 0 {
+            stats.tokens += 1;
+        }
+        if node.is_error() || node.is_missing() {
+            stats.errors += 1;
+        }
+        if cursor.goto_first_child() || cursor.goto_next_sibling() {
+            continue;
+        }
+        loop {
+            if !cursor.goto_parent() {
+                return stats;
+            }
+            if cursor.goto_next_sibling() {
+                break;
+            }
+        }
+    }
+}
+
+/// Stack version counts seen while parsing `source`.
+pub struct StackStats {
+    pub max_versions: usize,
+    pub forked_steps: usize,
+    pub steps: usize,
+}
+
+pub fn stack_stats(parser: &mut Parser, source: &str) -> StackStats {
+    let max_versions = Arc::new(AtomicUsize::new(0));
+    let forked_steps = Arc::new(AtomicUsize::new(0));
+    let steps = Arc::new(AtomicUsize::new(0));
+    {
+        let (max_versions, forked_steps, steps) =
+            (max_versions.clone(), forked_steps.clone(), steps.clone());
+        // The parser logs "process version:N, version_count:M, ..." once per
+        // step of every stack version.
+        parser.set_logger(Some(Box::new(move |log_type, message| {
+            if !matches!(log_type, LogType::Parse) || !message.starts_with("process ") {
+                return;
+            }
+            let Some(count) = message
+                .split(", ")
+                .find_map(|part| part.strip_prefix("version_count:"))
+                .and_then(|count| count.parse::<usize>().ok())
+            else {
+                return;
+            };
+            steps.fetch_add(1, Ordering::Relaxed);
+            if count > 1 {
+                forked_steps.fetch_add(1, Ordering::Relaxed);
+            }
+            max_versions.fetch_max(count, Ordering::Relaxed);
+        })));
+    }
+    parser.parse(source, None).unwrap();
+    parser.set_logger(None);
+
+    StackStats {
+        max_versions: max_versions.load(Ordering::Relaxed),
+        forked_steps: forked_steps.load(Ordering::Relaxed),
+        steps: steps.load(Ordering::Relaxed),
+    }
+}
+
+/// Process peak resident set size in KiB, if the platform exposes it.
+pub fn peak_rss_kib() -> Option<u64> {
+    let status = std::fs::read_to_string("/proc/self/status").ok()?;
+    status
+        .lines()
+        .find_map(|line| line.strip_prefix("VmHWM:"))
+        .and_then(|rest| rest.trim().trim_end_matches("kB").trim().parse().ok())
+}
+
+fn main() {
+    // `cargo bench` passes `--bench`; anything else is a name filter.
+    let filter: Vec<String> = std::env::args()
+        .skip(1)
+        .filter(|arg| !arg.starts_with("--"))
+        .collect();
+
+    let mut inputs = corpus::load();
+    inputs.retain(|input| filter.is_empty() || filter.iter().any(|f| input.name.contains(f)));
+    inputs.sort_by_key(|input| input.source.len());
+
+    println!(
+        "{:<12} {:<32} {:>10} {:>9} {:>9} {:>10} {:>10} {:>7} {:>10} {:>7} {:>10}",
+        "grammar",
+        "input",
+        "bytes",
+        "iters",
+        "MB/s",
+        "ns/token",
+        "nodes",
+        "errors",
+        "max stacks",
+        "forked",
+        "peak RSS"
+    );
+
+    for (name, language) in grammars() {
+        let mut parser = Parser::new();
+        parser
+            .set_language(&language.into())
+            .expect("Error loading JASS grammar");
+
+        for input in &inputs {
+            let tree = parser.parse(&input.source, None).unwrap();
+            let stats = tree_stats(&tree);
+            drop(tree);
+            let stacks = stack_stats(&mut parser, &input.source);
+
+            let mut iterations = 0;
+            let mut elapsed = Duration::ZERO;
+            while elapsed < MIN_TIME && iterations < MAX_ITERATIONS {
+                let start = Instant::now();
+                let tree = parser.parse(&input.source, None).unwrap();
+                elapsed += start.elapsed();
+                drop(tree);
+                iterations += 1;
+            }
+
+            let per_parse = elapsed.as_secs_f64() / iterations as f64;
+            let mb_per_s = input.source.len() as f64 / per_parse / 1e6;
+            let ns_per_token = per_parse * 1e9 / stats.tokens.max(1) as f64;
+            let rss = peak_rss_kib().map_or_else(|| "n/a".into(), |kib| format!("{} KiB", kib));
+
+            let forked = 100.0 * stacks.forked_steps as f64 / stacks.steps.max(1) as f64;
+
+            println!(
+                "{:<12} {:<32} {:>10} {:>9} {:>9.2} {:>10.1} {:>10} {:>7} {:>10} {:>6.2}% {:>10}",
+                name,
+                input.name,
+                input.source.len(),
+                iterations,
+                mb_per_s,
+                ns_per_token,
+                stats.nodes,
+                stats.errors,
+                stacks.max_versions,
+                forked,
+                rss
+            );
+        }
+    }
+}
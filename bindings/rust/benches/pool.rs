@@ -0,0 +1,86 @@
+//! Parallel parsing benchmark for `ParserPool`.
+//!
+//! Parses a batch of many map-sized files with `ParserPool::parse_sources`
+//! on rayon pools of 1, 2, 4, ... threads up to the number of CPUs, and
+//! reports throughput, speedup over one thread and parallel efficiency.
+//!
+//! ```sh
+//! cargo bench --bench pool --features pool
+//! JASS_BENCH_CORPUS=path/to/maps cargo bench --bench pool --features pool
+//! ```
+//!
+//! Without `$JASS_BENCH_CORPUS` the batch is `BATCH_FILES` generated maps
+//! of varying size; with it, every `.j` file found there.
+
+mod corpus;
+
+use std::time::{Duration, Instant};
+
+use tree_sitter_jass::ParserPool;
+
+/// Number of generated files when no real corpus is given.
+const BATCH_FILES: usize = 2_000;
+/// Each thread count is timed this many times; the fastest run counts.
+const RUNS: usize = 3;
+
+fn batch() -> Vec<String> {
+    if let Some(dir) = std::env::var_os(corpus::CORPUS_DIR_ENV) {
+        return corpus::jass_files(std::path::Path::new(&dir))
+            .iter()
+            .filter_map(|path| std::fs::read(path).ok())
+            .map(|bytes| String::from_utf8_lossy(&bytes).into_owned())
+            .collect();
+    }
+    // 2..64 KiB: small trigger files up to typical war3map.j sizes
+    let mut rng = corpus::Rng::new(0x706f_6f6c);
+    (0..BATCH_FILES)
+        .map(|_| corpus::generate_map((2 + rng.below(63)) << 10))
+        .collect()
+}
+
+fn thread_counts() -> Vec<usize> {
+    let cpus = std::thread::available_parallelism().map_or(1, |n| n.get());
+    let mut counts: Vec<usize> = (0..).map(|i| 1 << i).take_while(|&n| n < cpus).collect();
+    counts.push(cpus);
+    counts
+}
+
+fn main() {
+    let sources = batch();
+    let bytes: usize = sources.iter().map(String::len).sum();
+    println!("{} files, {} bytes", sources.len(), bytes);
+
+    let parsers = ParserPool::new(tree_sitter_jass::language());
+
+    println!(
+        "{:>8} {:>12} {:>9} {:>9} {:>11}",
+        "threads", "time", "MB/s", "speedup", "efficiency"
+    );
+
+    let mut baseline = None;
+    for threads in thread_counts() {
+        let rayon_pool = rayon::ThreadPoolBuilder::new()
+            .num_threads(threads)
+            .build()
+            .expect("Error building thread pool");
+
+        let mut best = Duration::MAX;
+        for _ in 0..RUNS {
+            let start = Instant::now();
+            let trees = rayon_pool.install(|| parsers.parse_sources(&sources));
+            best = best.min(start.elapsed());
+            drop(trees);
+        }
+
+        let baseline = *baseline.get_or_insert(best);
+        let speedup = baseline.as_secs_f64() / best.as_secs_f64();
+        println!(
+            "{:>8} {:>10.1}ms {:>9.2} {:>8.2}x {:>10.0}%",
+            threads,
+            best.as_secs_f64() * 1e3,
+            bytes as f64 / best.as_secs_f64() / 1e6,
+            speedup,
+            100.0 * speedup / threads as f64
+        );
+    }
+}
@@ -0,0 +1,149 @@
+//! Query execution benchmark.
+//!
+//! Runs the shipped `highlights.scm`, `locals.scm` and `tags.scm` over the
+//! corpus from `corpus.rs` (the generated 5 MB map is well over 50k lines)
+//! and reports, per query and input: the time to run the query over the
+//! whole tree, MB/s, captures, and the time for one editor viewport of
+//! `VIEWPORT_LINES` lines in the middle of the file, which is what a
+//! highlighter re-runs on scroll.
+//!
+//! ```sh
+//! cargo bench --bench query
+//! cargo bench --bench query map-5m   # only matching inputs
+//! JASS_BENCH_CORPUS=path/to/maps cargo bench --bench query
+//! ```
+//!
+//! Highlights run through `captures` (in document order, as a highlighter
+//! consumes them); locals and tags through `matches`.
+
+mod corpus;
+
+use std::time::{Duration, Instant};
+
+use tree_sitter::{Parser, Query, QueryCursor, StreamingIterator, Tree};
+
+/// Minimum wall time spent on each query and input.
+const MIN_TIME: Duration = Duration::from_millis(500);
+/// Iterations are capped so tiny inputs don't run forever.
+const MAX_ITERATIONS: usize = 10_000;
+/// Lines in the viewport measurement.
+const VIEWPORT_LINES: usize = 100;
+
+const QUERIES: &[(&str, &str, bool)] = &[
+    ("highlights", tree_sitter_jass::HIGHLIGHTS_QUERY, true),
+    ("locals", tree_sitter_jass::LOCALS_QUERY, false),
+    ("tags", tree_sitter_jass::TAGS_QUERY, false),
+];
+
+/// Runs `query` once over `range` of the tree and returns the number of
+/// captures seen.
+fn run(
+    cursor: &mut QueryCursor,
+    query: &Query,
+    tree: &Tree,
+    source: &[u8],
+    range: std::ops::Range<usize>,
+    captures: bool,
+) -> usize {
+    cursor.set_byte_range(range);
+    let mut count = 0;
+    if captures {
+        let mut iter = cursor.captures(query, tree.root_node(), source);
+        while iter.next().is_some() {
+            count += 1;
+        }
+    } else {
+        let mut iter = cursor.matches(query, tree.root_node(), source);
+        while let Some(m) = iter.next() {
+            count += m.captures.len();
+        }
+    }
+    count
+}
+
+/// Mean time of `f`, run for at least `MIN_TIME`.
+fn time(mut f: impl FnMut()) -> Duration {
+    let mut iterations = 0;
+    let mut elapsed = Duration::ZERO;
+    while elapsed < MIN_TIME && iterations < MAX_ITERATIONS {
+        let start = Instant::now();
+        f();
+        elapsed += start.elapsed();
+        iterations += 1;
+    }
+    elapsed / iterations as u32
+}
+
+/// Byte range of `VIEWPORT_LINES` lines around the middle of `source`.
+fn viewport(source: &str) -> std::ops::Range<usize> {
+    let starts: Vec<usize> = std::iter::once(0)
+        .chain(source.match_indices('\n').map(|(i, _)| i + 1))
+        .collect();
+    let first = starts.len().saturating_sub(VIEWPORT_LINES) / 2;
+    let end = starts.get(first + VIEWPORT_LINES).copied().unwrap_or(source.len());
+    starts[first]..end
+}
+
+fn main() {
+    // `cargo bench` passes `--bench`; anything else is a name filter.
+    let filter: Vec<String> = std::env::args()
+        .skip(1)
+        .filter(|arg| !arg.starts_with("--"))
+        .collect();
+
+    let mut inputs = corpus::load();
+    inputs.retain(|input| filter.is_empty() || filter.iter().any(|f| input.name.contains(f)));
+    inputs.sort_by_key(|input| input.source.len());
+
+    let language: tree_sitter::Language = tree_sitter_jass::language().into();
+    let mut parser = Parser::new();
+    parser.set_language(&language).expect("Error loading JASS grammar");
+
+    println!("{:<12} {:>10}", "query", "compile");
+    let mut queries = Vec::new();
+    for &(name, source, captures) in QUERIES {
+        let start = Instant::now();
+        let query = Query::new(&language, source).expect("shipped queries compile");
+        println!("{:<12} {:>8.2}ms", name, start.elapsed().as_secs_f64() * 1e3);
+        queries.push((name, query, captures));
+    }
+    println!();
+
+    println!(
+        "{:<12} {:<32} {:>10} {:>8} {:>9} {:>9} {:>10} {:>12}",
+        "query", "input", "bytes", "lines", "ms", "MB/s", "captures", "viewport µs"
+    );
+    for input in &inputs {
+        let tree = parser.parse(&input.source, None).unwrap();
+        let source = input.source.as_bytes();
+        let lines = input.source.lines().count();
+        let whole = 0..source.len();
+        let visible = viewport(&input.source);
+
+        for (name, query, captures) in &queries {
+            let mut cursor = QueryCursor::new();
+            let count = run(&mut cursor, query, &tree, source, whole.clone(), *captures);
+            let per_run = time(|| {
+                run(&mut cursor, query, &tree, source, whole.clone(), *captures);
+            });
+            let per_viewport = time(|| {
+                run(&mut cursor, query, &tree, source, visible.clone(), *captures);
+            });
+            if cursor.did_exceed_match_limit() {
+                eprintln!("{}: {} exceeded the match limit", input.name, name);
+            }
+
+            println!(
+                "{:<12} {:<32} {:>10} {:>8} {:>9.3} {:>9.2} {:>10} {:>12.1}",
+                name,
+                input.name,
+                source.len(),
+                lines,
+                per_run.as_secs_f64() * 1e3,
+                source.len() as f64 / per_run.as_secs_f64() / 1e6,
+                count,
+                per_viewport.as_secs_f64() * 1e6
+            );
+        }
+    }
+}
@@ -0,0 +1,188 @@
+//! Worst-case scaling check on adversarial inputs.
+//!
+//! Parses each generator of `corpus::ADVERSARIAL` (deeply nested unclosed
+//! blocks, stray closers, unterminated literals, ...) at doubling sizes and
+//! fits the growth of parse time and of peak runtime heap against input
+//! size. The process exits with status 1 if either grows faster than
+//! `MAX_EXPONENT`, so CI can run it as a test:
+//!
+//! ```sh
+//! cargo bench --bench scaling
+//! cargo bench --bench scaling nested-if   # only matching cases
+//! ```
+//!
+//! Peak heap is measured exactly by routing the tree-sitter runtime's
+//! allocations through counting hooks (`tree_sitter::set_allocator`), so
+//! the memory check doesn't depend on RSS noise.
+
+mod corpus;
+
+use std::alloc::{Layout, alloc, dealloc, realloc};
+use std::ffi::c_void;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+
+use tree_sitter::Parser;
+
+/// Repetitions of each pattern; the largest gives 10,000 nested blocks.
+const SIZES: &[usize] = &[1_250, 2_500, 5_000, 10_000];
+/// Each size is timed this many times; the fastest run counts.
+const RUNS: usize = 3;
+/// Largest accepted exponent k in cost ~ bytes^k. Linear is 1; the slack
+/// absorbs timer noise on the small sizes, quadratic behavior is far above.
+const MAX_EXPONENT: f64 = 1.3;
+
+// --- Heap accounting for the runtime ---
+
+const HEADER: usize = 16;
+
+static LIVE: AtomicUsize = AtomicUsize::new(0);
+static PEAK: AtomicUsize = AtomicUsize::new(0);
+
+fn layout(size: usize) -> Layout {
+    Layout::from_size_align(size + HEADER, HEADER).unwrap()
+}
+
+unsafe fn track(base: *mut u8, size: usize) -> *mut c_void {
+    if base.is_null() {
+        return std::ptr::null_mut();
+    }
+    unsafe { (base as *mut usize).write(size) };
+    let live = LIVE.fetch_add(size, Ordering::Relaxed) + size;
+    PEAK.fetch_max(live, Ordering::Relaxed);
+    unsafe { base.add(HEADER) as *mut c_void }
+}
+
+unsafe extern "C" fn counting_malloc(size: usize) -> *mut c_void {
+    unsafe { track(alloc(layout(size)), size) }
+}
+
+unsafe extern "C" fn counting_calloc(count: usize, size: usize) -> *mut c_void {
+    let size = count * size;
+    let block = unsafe { counting_malloc(size) };
+    if !block.is_null() {
+        unsafe { std::ptr::write_bytes(block as *mut u8, 0, size) };
+    }
+    block
+}
+
+unsafe extern "C" fn counting_realloc(ptr: *mut c_void, size: usize) -> *mut c_void {
+    if ptr.is_null() {
+        return unsafe { counting_malloc(size) };
+    }
+    let base = unsafe { (ptr as *mut u8).sub(HEADER) };
+    let old = unsafe { (base as *const usize).read() };
+    let moved = unsafe { realloc(base, layout(old), size + HEADER) };
+    if moved.is_null() {
+        return std::ptr::null_mut();
+    }
+    LIVE.fetch_sub(old, Ordering::Relaxed);
+    unsafe { track(moved, size) }
+}
+
+unsafe extern "C" fn counting_free(ptr: *mut c_void) {
+    if ptr.is_null() {
+        return;
+    }
+    let base = unsafe { (ptr as *mut u8).sub(HEADER) };
+    let size = unsafe { (base as *const usize).read() };
+    LIVE.fetch_sub(size, Ordering::Relaxed);
+    unsafe { dealloc(base, layout(size)) };
+}
+
+// --- Measurement ---
+
+struct Sample {
+    bytes: usize,
+    time: Duration,
+    peak_heap: usize,
+}
+
+fn measure(parser: &mut Parser, source: &str) -> Sample {
+    let mut time = Duration::MAX;
+    PEAK.store(LIVE.load(Ordering::Relaxed), Ordering::Relaxed);
+    let base = LIVE.load(Ordering::Relaxed);
+    for _ in 0..RUNS {
+        let start = Instant::now();
+        let tree = parser.parse(source, None).unwrap();
+        time = time.min(start.elapsed());
+        drop(tree);
+    }
+    Sample {
+        bytes: source.len(),
+        time,
+        peak_heap: PEAK.load(Ordering::Relaxed) - base,
+    }
+}
+
+/// Exponent k of cost ~ bytes^k from the smallest to the largest sample.
+fn exponent(samples: &[Sample], cost: impl Fn(&Sample) -> f64) -> f64 {
+    let (first, last) = (&samples[0], &samples[samples.len() - 1]);
+    (cost(last) / cost(first)).ln() / (last.bytes as f64 / first.bytes as f64).ln()
+}
+
+fn main() {
+    // Before the first parser exists, so every runtime block is tracked
+    unsafe {
+        tree_sitter::set_allocator(
+            Some(counting_malloc),
+            Some(counting_calloc),
+            Some(counting_realloc),
+            Some(counting_free),
+        );
+    }
+
+    let filter: Vec<String> = std::env::args()
+        .skip(1)
+        .filter(|arg| !arg.starts_with("--"))
+        .collect();
+
+    let mut parser = Parser::new();
+    parser
+        .set_language(&tree_sitter_jass::language().into())
+        .expect("Error loading JASS grammar");
+
+    println!(
+        "{:<22} {:>8} {:>10} {:>11} {:>12}",
+        "case", "n", "bytes", "time", "peak heap"
+    );
+
+    let mut failed = Vec::new();
+    for &(name, generate) in corpus::ADVERSARIAL {
+        if !filter.is_empty() && !filter.iter().any(|f| name.contains(f.as_str())) {
+            continue;
+        }
+        let mut samples = Vec::new();
+        for &n in SIZES {
+            let sample = measure(&mut parser, &generate(n));
+            println!(
+                "{:<22} {:>8} {:>10} {:>9.2}ms {:>8} KiB",
+                name,
+                n,
+                sample.bytes,
+                sample.time.as_secs_f64() * 1e3,
+                sample.peak_heap >> 10
+            );
+            samples.push(sample);
+        }
+
+        let time_k = exponent(&samples, |s| s.time.as_secs_f64());
+        let heap_k = exponent(&samples, |s| s.peak_heap.max(1) as f64);
+        let ok = time_k <= MAX_EXPONENT && heap_k <= MAX_EXPONENT;
+        println!(
+            "{:<22} time ~ n^{:.2}, heap ~ n^{:.2}: {}",
+            name,
+            time_k,
+            heap_k,
+            if ok { "ok" } else { "SUPER-LINEAR" }
+        );
+        if !ok {
+            failed.push(name);
+        }
+    }
+
+    if !failed.is_empty() {
+        eprintln!("super-linear scaling: {}", failed.join(", "));
+        std::process::exit(1);
+    }
+}
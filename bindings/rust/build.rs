@@ -7,6 +7,8 @@ fn main() {
         .flag_if_supported("-Wno-unused-parameter")
         .flag_if_supported("-Wno-unused-but-set-variable")
         .flag_if_supported("-Wno-trigraphs");
+    scanner_defines(&mut c_config);
+    optimization_flags(&mut c_config);
     let parser_path = src_dir.join("parser.c");
     c_config.file(&parser_path);
 
@@ -17,9 +19,87 @@ fn main() {
     c_config.file(&scanner_path);
     println!("cargo:rerun-if-changed={}", scanner_path.to_str().unwrap());
 
+    // Scanner shared by every grammar variant
+    for shared in ["common/scanner.h", "common/keywords.h", "common/scanner_stats.h"] {
+        println!("cargo:rerun-if-changed={}", shared);
+    }
+
     c_config.compile("parser");
     println!("cargo:rerun-if-changed={}", parser_path.to_str().unwrap());
 
+    // Allocator hooks for the runtime, linked against the tree-sitter crate
+    if std::env::var_os("CARGO_FEATURE_ARENA").is_some() {
+        let alloc_path = std::path::Path::new("bindings/c/alloc.c");
+        cc::Build::new()
+            .file(alloc_path)
+            .std("c11")
+            .compile("jass_alloc");
+        println!("cargo:rerun-if-changed={}", alloc_path.to_str().unwrap());
+        println!("cargo:rerun-if-changed=bindings/c/alloc.h");
+    }
+
+    // File mapping for parse_path
+    if std::env::var_os("CARGO_FEATURE_MMAP").is_some() {
+        let mapped_path = std::path::Path::new("bindings/c/mapped.c");
+        cc::Build::new()
+            .file(mapped_path)
+            .std("c11")
+            .compile("jass_mapped");
+        println!("cargo:rerun-if-changed={}", mapped_path.to_str().unwrap());
+        println!("cargo:rerun-if-changed=bindings/c/mapped.h");
+    }
+
+    // Symbol table format for SymbolTable / SymbolCache
+    if std::env::var_os("CARGO_FEATURE_SYMBOLS").is_some() {
+        let symtab_path = std::path::Path::new("bindings/c/symtab.c");
+        cc::Build::new()
+            .file(symtab_path)
+            .std("c11")
+            .compile("jass_symtab");
+        println!("cargo:rerun-if-changed={}", symtab_path.to_str().unwrap());
+        println!("cargo:rerun-if-changed=bindings/c/symtab.h");
+    }
+
+    // Outline walker; the tree-sitter crate exports its include directory
+    if std::env::var_os("CARGO_FEATURE_OUTLINE").is_some() {
+        let outline_path = std::path::Path::new("bindings/c/outline.c");
+        let mut outline_config = cc::Build::new();
+        if let Some(include) = std::env::var_os("DEP_TREE_SITTER_INCLUDE") {
+            outline_config.include(include);
+        }
+        outline_config.file(outline_path).std("c11").compile("jass_outline");
+        println!("cargo:rerun-if-changed={}", outline_path.to_str().unwrap());
+        println!("cargo:rerun-if-changed=bindings/c/outline.h");
+    }
+
+    // Literal decoder, also over the runtime's cursors
+    if std::env::var_os("CARGO_FEATURE_LITERALS").is_some() {
+        let literals_path = std::path::Path::new("bindings/c/literals.c");
+        let mut literals_config = cc::Build::new();
+        if let Some(include) = std::env::var_os("DEP_TREE_SITTER_INCLUDE") {
+            literals_config.include(include);
+        }
+        literals_config.file(literals_path).std("c11").compile("jass_literals");
+        println!("cargo:rerun-if-changed={}", literals_path.to_str().unwrap());
+        println!("cargo:rerun-if-changed=bindings/c/literals.h");
+    }
+
+    // Top-level split pre-scanner for ParserPool::parse_split
+    if std::env::var_os("CARGO_FEATURE_POOL").is_some() {
+        let split_path = std::path::Path::new("bindings/c/split.c");
+        let prescan_path = std::path::Path::new("bindings/c/prescan.c");
+        cc::Build::new()
+            .include("common")
+            .file(split_path)
+            .file(prescan_path)
+            .std("c11")
+            .compile("jass_split");
+        println!("cargo:rerun-if-changed={}", split_path.to_str().unwrap());
+        println!("cargo:rerun-if-changed={}", prescan_path.to_str().unwrap());
+        println!("cargo:rerun-if-changed=bindings/c/split.h");
+        println!("cargo:rerun-if-changed=bindings/c/prescan.h");
+    }
+
     // If your language uses an external scanner written in C++,
     // then include this block of code:
 
@@ -36,3 +116,63 @@ fn main() {
     println!("cargo:rerun-if-changed={}", scanner_path.to_str().unwrap());
     */
 }
+
+fn scanner_defines(c_config: &mut cc::Build) {
+    if std::env::var_os("CARGO_FEATURE_SCANNER_STATS").is_some() {
+        c_config.define("JASS_SCANNER_STATS", None);
+    }
+}
+
+// Opt-in optimized builds of the parsers and scanners (README, "Optimized
+// builds"). The grammar is a 35k-line parse table plus branchy lexers, the
+// kind of code that gains from -O3, LTO and profile-guided layout.
+//
+//   JASS_OPTIMIZE=1          -O3
+//   JASS_LTO=1               cross-language ThinLTO; needs clang and
+//                            RUSTFLAGS="-Clinker-plugin-lto -Clinker=clang"
+//   JASS_PGO_GENERATE=<dir>  instrumented build writing profiles to <dir>
+//   JASS_PGO_USE=<dir>       build with the profiles in <dir> (GCC .gcda
+//                            files, or default.profdata for clang)
+//
+// script/pgo.js runs the whole training pipeline.
+fn optimization_flags(c_config: &mut cc::Build) {
+    for name in ["JASS_OPTIMIZE", "JASS_LTO", "JASS_PGO_GENERATE", "JASS_PGO_USE"] {
+        println!("cargo:rerun-if-env-changed={}", name);
+    }
+    let enabled = |name: &str| std::env::var_os(name).is_some_and(|value| !value.is_empty() && value != "0");
+    let clang = c_config.get_compiler().is_like_clang();
+
+    if enabled("JASS_OPTIMIZE") {
+        c_config.opt_level(3);
+    }
+    if enabled("JASS_LTO") {
+        if clang {
+            c_config.flag("-flto=thin");
+        } else {
+            println!("cargo:warning=JASS_LTO needs clang (CC=clang); building without LTO");
+        }
+    }
+
+    if let Some(dir) = std::env::var_os("JASS_PGO_GENERATE") {
+        let dir = std::path::PathBuf::from(dir);
+        c_config.flag(&format!("-fprofile-generate={}", dir.display()));
+        if clang {
+            // The profiler runtime comes with RUSTFLAGS=-Cprofile-generate
+            println!("cargo:warning=JASS_PGO_GENERATE with clang needs RUSTFLAGS=-Cprofile-generate={}", dir.display());
+        } else {
+            // Parsers run on several threads in the pool and benchmarks
+            c_config.flag("-fprofile-update=atomic");
+            println!("cargo:rustc-link-lib=gcov");
+        }
+    } else if let Some(dir) = std::env::var_os("JASS_PGO_USE") {
+        let dir = std::path::PathBuf::from(dir);
+        c_config.flag(&format!("-fprofile-use={}", dir.display()));
+        if clang {
+            c_config.flag_if_supported("-Wno-profile-instr-unprofiled");
+            c_config.flag_if_supported("-Wno-profile-instr-out-of-date");
+        } else {
+            c_config.flag("-fprofile-correction");
+            c_config.flag_if_supported("-Wno-missing-profile");
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// Generated by script/generate-ids.js from src/parser.c.
+// Do not edit: run `node script/generate-ids.js` after `tree-sitter generate`.
+
+/// Node kind ids of the named node types, as returned by `Node::kind_id()`.
+pub mod kind {
+    pub const CALL_STATEMENT: u16 = 70;
+    pub const COMMENT: u16 = 49;
+    pub const ESCAPE_SEQUENCE: u16 = 51;
+    pub const EXITWHEN_STATEMENT: u16 = 67;
+    pub const EXPR: u16 = 64;
+    pub const FLOAT: u16 = 25;
+    pub const FUNCTION_ARGUMENTS: u16 = 81;
+    pub const FUNCTION_CALL: u16 = 80;
+    pub const FUNCTION_REF: u16 = 78;
+    pub const FUNCTION_STATEMENT: u16 = 74;
+    pub const GLOBALS: u16 = 75;
+    pub const ID: u16 = 59;
+    pub const IF_STATEMENT: u16 = 71;
+    pub const LOCAL_STATEMENT: u16 = 68;
+    pub const LOOP_STATEMENT: u16 = 61;
+    pub const NATIVE_STATEMENT: u16 = 72;
+    pub const NUMBER: u16 = 24;
+    pub const PARAMETER: u16 = 77;
+    pub const PARAMETER_LIST: u16 = 76;
+    pub const PARENS: u16 = 79;
+    pub const PROGRAM: u16 = 58;
+    pub const RAWCODE: u16 = 52;
+    pub const RETURN_STATEMENT: u16 = 66;
+    pub const SET_STATEMENT: u16 = 69;
+    pub const STRING: u16 = 65;
+    pub const TYPE_STATEMENT: u16 = 73;
+    pub const VAR_DECL: u16 = 63;
+    pub const VAR_STMT: u16 = 62;
+}
+
+/// Field ids, as taken by `Node::child_by_field_id()` and returned by
+/// `TreeCursor::field_id()`.
+pub mod field {
+    pub const ARGS: u16 = 1;
+    pub const BASE: u16 = 2;
+    pub const CONDITION: u16 = 3;
+    pub const INDEX: u16 = 4;
+    pub const NAME: u16 = 5;
+    pub const PARAMETERS: u16 = 6;
+    pub const RETURN_TYPE: u16 = 7;
+    pub const TYPE: u16 = 8;
+    pub const VALUE: u16 = 9;
+    pub const VARIABLE: u16 = 10;
+}
+
+/// Every `kind` constant with its node kind name.
+pub const KINDS: &[(&str, u16)] = &[
+    ("call_statement", 70),
+    ("comment", 49),
+    ("escape_sequence", 51),
+    ("exitwhen_statement", 67),
+    ("expr", 64),
+    ("float", 25),
+    ("function_arguments", 81),
+    ("function_call", 80),
+    ("function_ref", 78),
+    ("function_statement", 74),
+    ("globals", 75),
+    ("id", 59),
+    ("if_statement", 71),
+    ("local_statement", 68),
+    ("loop_statement", 61),
+    ("native_statement", 72),
+    ("number", 24),
+    ("parameter", 77),
+    ("parameter_list", 76),
+    ("parens", 79),
+    ("program", 58),
+    ("rawcode", 52),
+    ("return_statement", 66),
+    ("set_statement", 69),
+    ("string", 65),
+    ("type_statement", 73),
+    ("var_decl", 63),
+    ("var_stmt", 62),
+];
+
+/// Every `field` constant with its field name.
+pub const FIELDS: &[(&str, u16)] = &[
+    ("args", 1),
+    ("base", 2),
+    ("condition", 3),
+    ("index", 4),
+    ("name", 5),
+    ("parameters", 6),
+    ("return_type", 7),
+    ("type", 8),
+    ("value", 9),
+    ("variable", 10),
+];
@@ -22,6 +22,57 @@
 
 use tree_sitter_language::LanguageFn;
 
+mod ids;
+pub use ids::{FIELDS, KINDS, field, kind};
+
+mod stats;
+pub use stats::{ScannerStats, scanner_stats};
+
+#[cfg(feature = "arena")]
+mod arena;
+#[cfg(feature = "arena")]
+pub use arena::{AllocStats, ParseArena, count_allocations};
+
+#[cfg(feature = "literals")]
+mod literals;
+#[cfg(feature = "literals")]
+pub use literals::{Literal, LiteralKind, LiteralValue, literals};
+
+#[cfg(feature = "mmap")]
+mod mapped;
+#[cfg(feature = "mmap")]
+pub use mapped::{MappedFile, ParsedPath, parse_path};
+
+#[cfg(feature = "outline")]
+mod outline;
+#[cfg(feature = "outline")]
+pub use outline::{OutlineEntry, outline};
+
+#[cfg(feature = "pool")]
+mod pool;
+#[cfg(feature = "pool")]
+pub use pool::{Parsed, ParsedFile, ParserPool, PooledParser};
+
+#[cfg(feature = "pool")]
+mod split;
+#[cfg(feature = "pool")]
+pub use split::{ParsedChunk, SplitTree, Symbol};
+
+#[cfg(feature = "symbols")]
+mod symbols;
+#[cfg(feature = "symbols")]
+pub use symbols::{Declaration, SymbolCache, SymbolTable};
+
+/// The kind of a top-level declaration, as reported by
+/// `ParserPool::parse_split` and `outline` and stored in a `SymbolTable`.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum SymbolKind {
+    Function,
+    Native,
+    Type,
+    Global,
+}
+
 unsafe extern "C" {
     fn tree_sitter_jass() -> *const ();
 }
@@ -38,12 +89,15 @@ pub const fn language() -> LanguageFn {
 /// [`node-types.json`]: https://tree-sitter.github.io/tree-sitter/using-parsers#static-node-types
 pub const NODE_TYPES: &str = include_str!("../../src/node-types.json");
 
-// NOTE: uncomment these to include any queries that this grammar contains:
+/// The syntax highlighting query for the default grammar.
+pub const HIGHLIGHTS_QUERY: &str = include_str!("../../queries/highlights.scm");
+
+/// The local-variable query for the default grammar: function scopes,
+/// parameter and local definitions, references.
+pub const LOCALS_QUERY: &str = include_str!("../../queries/locals.scm");
 
-// pub const HIGHLIGHTS_QUERY: &str = include_str!("../../queries/highlights.scm");
-// pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
-// pub const LOCALS_QUERY: &str = include_str!("../../queries/locals.scm");
-// pub const TAGS_QUERY: &str = include_str!("../../queries/tags.scm");
+/// The symbol tagging query for the default grammar.
+pub const TAGS_QUERY: &str = include_str!("../../queries/tags.scm");
 
 #[cfg(test)]
 mod tests {
@@ -54,4 +108,237 @@ mod tests {
             .set_language(&super::language().into())
             .expect("Error loading JASS grammar");
     }
+
+    #[test]
+    fn test_queries_compile() {
+        let language: tree_sitter::Language = super::language().into();
+        for (name, source) in [
+            ("highlights", super::HIGHLIGHTS_QUERY),
+            ("locals", super::LOCALS_QUERY),
+            ("tags", super::TAGS_QUERY),
+        ] {
+            if let Err(error) = tree_sitter::Query::new(&language, source) {
+                panic!("{} query: {}", name, error);
+            }
+        }
+    }
+
+    #[test]
+    fn test_ids_match_language() {
+        let language: tree_sitter::Language = super::language().into();
+        for &(name, id) in super::ids::KINDS {
+            assert_eq!(language.id_for_node_kind(name, true), id, "kind {}", name);
+        }
+        for &(name, id) in super::ids::FIELDS {
+            let actual = language.field_id_for_name(name).map_or(0, |id| id.get());
+            assert_eq!(actual, id, "field {}", name);
+        }
+    }
+
+    #[cfg(feature = "pool")]
+    #[test]
+    fn test_pool_parses_in_input_order() {
+        let pool = super::ParserPool::new(super::language());
+        let sources = ["globals\nendglobals\n", "function F takes nothing returns nothing\n"];
+        let trees = pool.parse_sources(&sources);
+        assert!(!trees[0].root_node().has_error());
+        assert_eq!(trees[1].root_node().child(0).unwrap().kind(), "function_statement");
+    }
+
+    #[cfg(feature = "pool")]
+    #[test]
+    fn test_split_parse_matches_whole_parse() {
+        let source = b"globals\n    integer x = 1\nendglobals\n\
+            function A takes nothing returns nothing\n    call B()\nendfunction\n\
+            native B takes nothing returns nothing\n";
+        let pool = super::ParserPool::new(super::language());
+        let split = pool.parse_split(source, 1);
+        assert!(!split.fell_back);
+        assert_eq!(split.chunks.len(), 3);
+        let whole = pool.get().parse(source, None).unwrap();
+        let chunked: Vec<String> = split
+            .chunks
+            .iter()
+            .flat_map(|chunk| {
+                let root = chunk.tree.root_node();
+                (0..root.named_child_count()).map(move |i| root.named_child(i).unwrap().to_sexp())
+            })
+            .collect();
+        let root = whole.root_node();
+        let expected: Vec<String> = (0..root.named_child_count())
+            .map(|i| root.named_child(i).unwrap().to_sexp())
+            .collect();
+        assert_eq!(chunked, expected);
+        let names: Vec<&str> = split.symbols.iter().map(|symbol| symbol.name.as_str()).collect();
+        assert_eq!(names, ["x", "A", "B"]);
+    }
+
+    #[cfg(feature = "scanner-stats")]
+    #[test]
+    fn test_scanner_stats_count_tokens() {
+        let mut parser = tree_sitter::Parser::new();
+        parser.set_language(&super::language().into()).unwrap();
+        super::scanner_stats(true);
+        parser.parse("// note\nglobals\n    integer i = 'hfoo'\n", None).unwrap();
+        let stats = super::scanner_stats(true).expect("built with JASS_SCANNER_STATS");
+        assert!(stats.invocations >= stats.error_recovery);
+        assert!(stats.tokens[0] >= 1, "comment");
+        assert!(stats.tokens[3] >= 1, "rawcode");
+        assert!(stats.tokens[4] >= 1, "identifier");
+        assert!(stats.tokens[6] >= 1, "virtual endglobals at EOF");
+        assert_eq!(super::scanner_stats(false).unwrap().invocations, 0);
+    }
+
+    #[cfg(feature = "arena")]
+    #[test]
+    fn test_arena_parse_is_counted() {
+        let language: tree_sitter::Language = super::language().into();
+        let mut arena = super::ParseArena::new();
+        let source = b"globals\n    integer i = 0\nendglobals\n";
+        let (kind, stats) = super::count_allocations(|| {
+            arena.parse(&language, source, |root| root.child(0).unwrap().kind())
+        });
+        assert_eq!(kind, "globals");
+        assert!(stats.calls > 0);
+        assert!(arena.used() > 0);
+    }
+
+    #[cfg(feature = "mmap")]
+    #[test]
+    fn test_parse_path_matches_string_parse() {
+        let source = "function F takes nothing returns nothing\n    call X(\"a\")\nendfunction\n";
+        let path = std::env::temp_dir().join(format!("tree-sitter-jass-{}.j", std::process::id()));
+        std::fs::write(&path, source).unwrap();
+
+        let mut parser = tree_sitter::Parser::new();
+        parser.set_language(&super::language().into()).unwrap();
+        let parsed = super::parse_path(&mut parser, &path).unwrap();
+        let expected = parser.parse(source, None).unwrap();
+        std::fs::remove_file(&path).unwrap();
+
+        assert_eq!(&*parsed.source, source.as_bytes());
+        assert_eq!(parsed.tree.root_node().to_sexp(), expected.root_node().to_sexp());
+        assert!(super::parse_path(&mut parser, &path).is_err());
+    }
+
+    #[cfg(feature = "symbols")]
+    #[test]
+    fn test_symbol_cache_maps_unchanged_source() {
+        let source = "type unit extends widget\n\
+            globals\n    constant integer A = 1\n    real array B, C\nendglobals\n\
+            constant native GetUnitX takes unit whichUnit returns real\n\
+            function F takes nothing returns nothing\nendfunction\n";
+        let dir = std::env::temp_dir().join(format!("tree-sitter-jass-symbols-{}", std::process::id()));
+        let cache = super::SymbolCache::new(&dir);
+
+        let mut parser = tree_sitter::Parser::new();
+        parser.set_language(&super::language().into()).unwrap();
+        let built = cache.load_source(&mut parser, source.as_bytes()).unwrap();
+        let cached = cache.load_source(&mut parser, source.as_bytes()).unwrap();
+        std::fs::remove_dir_all(&dir).unwrap();
+
+        assert!(!built.is_mapped());
+        assert!(cached.is_mapped());
+        assert_eq!(built.as_bytes(), cached.as_bytes());
+        let names: Vec<_> = cached.iter().map(|declaration| declaration.name).collect();
+        assert_eq!(names, ["unit", "A", "B", "C", "GetUnitX", "F"]);
+
+        let native = cached.find("GetUnitX").unwrap();
+        assert_eq!(native.kind, super::SymbolKind::Native);
+        assert!(native.constant);
+        assert_eq!((native.parameters, native.type_name), ("unit whichUnit", "real"));
+        let global = cached.find("C").unwrap();
+        assert!(global.array && !global.constant);
+        assert_eq!(global.type_name, "real");
+        assert!(cached.find("G").is_none());
+
+        let language: tree_sitter::Language = super::language().into();
+        assert!(cached.is_for(&language));
+        assert_eq!(cached.abi_version(), language.abi_version());
+        // A name index out of order would make find() miss names
+        let mut bytes = cached.as_bytes().to_vec();
+        let index = 40 + cached.len() * 32;
+        bytes[index..index + 8].rotate_left(4);
+        assert!(super::SymbolTable::from_bytes(bytes).is_none());
+    }
+
+    #[cfg(feature = "outline")]
+    #[test]
+    fn test_outline_lists_top_level_declarations() {
+        let source = b"globals\n    constant real array A, B\nendglobals\n\
+            function F takes integer i returns boolean\n    local integer x = i\n    return true\nendfunction\n\
+            type unit extends widget\n";
+        let mut parser = tree_sitter::Parser::new();
+        parser.set_language(&super::language().into()).unwrap();
+        let tree = parser.parse(source, None).unwrap();
+        let mut entries = Vec::new();
+        super::outline(&tree, &mut entries);
+
+        let names: Vec<_> = entries.iter().map(|entry| entry.name(source)).collect();
+        assert_eq!(names, ["A", "B", "F", "unit"]);
+        assert!(entries[1].constant() && entries[1].array());
+        assert_eq!(entries[1].type_name(source), "real");
+        assert_eq!(entries[2].kind(), super::SymbolKind::Function);
+        assert_eq!((entries[2].parameters(source), entries[2].type_name(source)), ("integer i", "boolean"));
+        assert_eq!(entries[3].type_name(source), "widget");
+        assert_eq!(entries[3].start_position().row, 7);
+    }
+
+    #[cfg(feature = "literals")]
+    #[test]
+    fn test_literals_decode_like_the_grammar() {
+        use super::{LiteralKind, LiteralValue};
+
+        let source = b"globals\n    integer a = $FFFFFFFF\n    integer b = 1_000ul\n    real c = .5f\nendglobals\n\
+            function F takes nothing returns nothing\n    call G(0b101, 'hfoo', 4294967296, 1e40)\nendfunction\n";
+        let mut parser = tree_sitter::Parser::new();
+        parser.set_language(&super::language().into()).unwrap();
+        let tree = parser.parse(source, None).unwrap();
+        let mut literals = Vec::new();
+        super::literals(&tree, source, &mut literals);
+
+        let values: Vec<_> = literals.iter().map(|literal| literal.value()).collect();
+        assert_eq!(
+            values,
+            [
+                LiteralValue::Integer(-1),
+                LiteralValue::Integer(1000),
+                LiteralValue::Real(0.5),
+                LiteralValue::Integer(5),
+                LiteralValue::Integer(0x6866_6F6F),
+                LiteralValue::Integer(0),
+                LiteralValue::Real(f32::INFINITY),
+            ]
+        );
+        assert!(literals[1].unsigned() && literals[1].long());
+        assert_eq!(literals[4].kind(), LiteralKind::Rawcode);
+        assert_eq!(&source[literals[4].byte_range()], b"'hfoo'");
+        assert!(literals[5].overflow() && literals[6].overflow());
+        assert!(literals.iter().all(|literal| !literal.invalid()));
+        assert_eq!(&source[literals[0].byte_range()], b"$FFFFFFFF");
+    }
+
+    #[cfg(feature = "literals")]
+    #[test]
+    fn test_number_suffix_is_one_of_l_u_ul() {
+        unsafe extern "C" {
+            fn jass_decode_number(text: *const std::ffi::c_char, length: usize, value: *mut u32) -> u8;
+        }
+        // JASS_LITERAL_UNSIGNED, _LONG and _INVALID of bindings/c/literals.h
+        const UNSIGNED: u8 = 1 << 1;
+        const LONG: u8 = 1 << 2;
+        const INVALID: u8 = 1 << 3;
+        let decode = |text: &str| {
+            let mut value = 0;
+            let flags = unsafe { jass_decode_number(text.as_ptr().cast(), text.len(), &mut value) };
+            (flags, value)
+        };
+
+        assert_eq!(decode("7l"), (LONG, 7));
+        assert_eq!(decode("7U"), (UNSIGNED, 7));
+        assert_eq!(decode("$7uL"), (UNSIGNED | LONG, 7));
+        for text in ["7lu", "7LU", "7ll", "7uu", "7ulu", "u", "$ul"] {
+            assert_ne!(decode(text).0 & INVALID, 0, "{text}");
+        }
+    }
 }
@@ -0,0 +1,150 @@
+//! Bulk decoding of number, float and rawcode literals (feature `literals`).
+//!
+//! [`literals`] runs `bindings/c/literals.c` over a whole tree once and
+//! decodes every literal straight from the source bytes, with the rules of
+//! the `number` and `float` tokens of `grammar.js` and the scanner's
+//! rawcodes: `$`/`0x` hex, `0b` binary, `_` separators, `l`/`u` suffixes,
+//! FourCC packing. No node text is copied or re-parsed in Rust.
+//!
+//! ```no_run
+//! # let (tree, source): (tree_sitter::Tree, &[u8]) = unimplemented!();
+//! use tree_sitter_jass::LiteralValue;
+//!
+//! let mut literals = Vec::new();
+//! tree_sitter_jass::literals(&tree, source, &mut literals);
+//! for literal in &literals {
+//!     match literal.value() {
+//!         LiteralValue::Integer(value) => println!("{:?} {}", literal.byte_range(), value),
+//!         LiteralValue::Real(value) => println!("{:?} {}", literal.byte_range(), value),
+//!     }
+//! }
+//! ```
+
+use std::ops::Range;
+
+use tree_sitter::{Tree, ffi::TSNode};
+
+unsafe extern "C" {
+    fn jass_literals(
+        root: TSNode,
+        source: *const u8,
+        length: usize,
+        literals: *mut Literal,
+        capacity: usize,
+    ) -> usize;
+}
+
+const OVERFLOW: u8 = 1 << 0;
+const UNSIGNED: u8 = 1 << 1;
+const LONG: u8 = 1 << 2;
+const INVALID: u8 = 1 << 3;
+
+/// The token a [`Literal`] was decoded from.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum LiteralKind {
+    Number,
+    Float,
+    Rawcode,
+}
+
+/// A decoded value: JASS integers and reals are 32 bits wide.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub enum LiteralValue {
+    Integer(i32),
+    Real(f32),
+}
+
+/// One literal, decoded; ranges are byte offsets into the source.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct Literal {
+    node_index: u32,
+    start_byte: u32,
+    end_byte: u32,
+    value: u32,
+    kind: u8,
+    flags: u8,
+    reserved: u16,
+}
+
+impl Literal {
+    pub fn kind(&self) -> LiteralKind {
+        match self.kind {
+            0 => LiteralKind::Number,
+            1 => LiteralKind::Float,
+            _ => LiteralKind::Rawcode,
+        }
+    }
+
+    /// Index of the node in a pre-order walk of all nodes from the root
+    /// (named or not), the numbering of the Node binding's `exportFlat`.
+    pub fn node_index(&self) -> usize {
+        self.node_index as usize
+    }
+
+    pub fn byte_range(&self) -> Range<usize> {
+        self.start_byte as usize..self.end_byte as usize
+    }
+
+    /// The raw 32 bits: an `i32` for numbers and rawcodes, an `f32` for
+    /// floats.
+    pub fn bits(&self) -> u32 {
+        self.value
+    }
+
+    pub fn value(&self) -> LiteralValue {
+        match self.kind() {
+            LiteralKind::Float => LiteralValue::Real(f32::from_bits(self.value)),
+            _ => LiteralValue::Integer(self.value as i32),
+        }
+    }
+
+    /// The literal does not fit: an integer beyond 32 bits or a rawcode
+    /// longer than 4 bytes (the value keeps the low 32 bits), or a float
+    /// beyond the `f32` range (the value is infinite).
+    pub fn overflow(&self) -> bool {
+        self.flags & OVERFLOW != 0
+    }
+
+    /// The number has a `u`/`U` suffix.
+    pub fn unsigned(&self) -> bool {
+        self.flags & UNSIGNED != 0
+    }
+
+    /// The number has an `l`/`L` suffix.
+    pub fn long(&self) -> bool {
+        self.flags & LONG != 0
+    }
+
+    /// The text is not a literal of its kind, which only happens when the
+    /// source is not the one the tree was parsed from; the value is 0.
+    pub fn invalid(&self) -> bool {
+        self.flags & INVALID != 0
+    }
+}
+
+/// Replaces the contents of `literals` with the decoded literals of
+/// `tree`, in source order. `source` must be the text the tree was parsed
+/// from. Reusing one `Vec` across calls avoids any allocation once it is
+/// large enough.
+pub fn literals(tree: &Tree, source: &[u8], literals: &mut Vec<Literal>) {
+    let root = tree.root_node().into_raw();
+    literals.clear();
+    loop {
+        let capacity = literals.capacity();
+        let count = unsafe {
+            jass_literals(
+                root,
+                source.as_ptr(),
+                source.len(),
+                literals.as_mut_ptr(),
+                capacity,
+            )
+        };
+        if count <= capacity {
+            unsafe { literals.set_len(count) };
+            return;
+        }
+        literals.reserve(count);
+    }
+}
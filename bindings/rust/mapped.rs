@@ -0,0 +1,120 @@
+//! Parsing files straight from a memory mapping (feature `mmap`).
+//!
+//! [`parse_path`] maps the file with `bindings/c/mapped.c` and hands the
+//! parser the mapped UTF-8 bytes through `parse_with_options`, so a large
+//! map is never copied into a `String` first. Where the file can't be
+//! mapped (pipes, platforms without mmap) it is read into one buffer.
+//!
+//! ```no_run
+//! let mut parser = tree_sitter::Parser::new();
+//! parser.set_language(&tree_sitter_jass::language().into()).unwrap();
+//! let parsed = tree_sitter_jass::parse_path(&mut parser, "war3map.j").unwrap();
+//! let root = parsed.tree.root_node();
+//! println!("{} bytes, error: {}", parsed.source.len(), root.has_error());
+//! ```
+
+use std::ffi::{CString, c_char, c_int, c_void};
+use std::io;
+use std::ops::Deref;
+use std::path::Path;
+
+use tree_sitter::{Parser, Tree};
+
+#[repr(C)]
+struct RawMappedFile {
+    data: *const c_char,
+    length: u32,
+    mapped: bool,
+    state: *mut c_void,
+}
+
+unsafe extern "C" {
+    fn jass_map_file(path: *const c_char, file: *mut RawMappedFile) -> c_int;
+    fn jass_unmap_file(file: *mut RawMappedFile);
+}
+
+/// The read-only bytes of a file, mapped or, failing that, buffered.
+///
+/// The file must not be truncated while it is mapped.
+pub struct MappedFile {
+    raw: RawMappedFile,
+}
+
+// The bytes are never written and the release needs no thread affinity
+unsafe impl Send for MappedFile {}
+unsafe impl Sync for MappedFile {}
+
+impl MappedFile {
+    pub fn open(path: impl AsRef<Path>) -> io::Result<Self> {
+        let path = c_path(path.as_ref())?;
+        let mut raw = RawMappedFile {
+            data: std::ptr::null(),
+            length: 0,
+            mapped: false,
+            state: std::ptr::null_mut(),
+        };
+        match unsafe { jass_map_file(path.as_ptr(), &mut raw) } {
+            0 => Ok(MappedFile { raw }),
+            error => Err(io::Error::from_raw_os_error(error)),
+        }
+    }
+
+    /// Whether the bytes come from a mapping rather than a buffered read.
+    pub fn is_mapped(&self) -> bool {
+        self.raw.mapped
+    }
+}
+
+impl Deref for MappedFile {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        unsafe { std::slice::from_raw_parts(self.raw.data.cast(), self.raw.length as usize) }
+    }
+}
+
+impl AsRef<[u8]> for MappedFile {
+    fn as_ref(&self) -> &[u8] {
+        self
+    }
+}
+
+impl Drop for MappedFile {
+    fn drop(&mut self) {
+        unsafe { jass_unmap_file(&mut self.raw) };
+    }
+}
+
+#[cfg(unix)]
+fn c_path(path: &Path) -> io::Result<CString> {
+    use std::os::unix::ffi::OsStrExt;
+    CString::new(path.as_os_str().as_bytes()).map_err(|e| io::Error::new(io::ErrorKind::InvalidInput, e))
+}
+
+// mapped.c takes UTF-8 elsewhere (and widens it on Windows)
+#[cfg(not(unix))]
+fn c_path(path: &Path) -> io::Result<CString> {
+    let path = path
+        .to_str()
+        .ok_or_else(|| io::Error::new(io::ErrorKind::InvalidInput, "path is not valid UTF-8"))?;
+    CString::new(path).map_err(|e| io::Error::new(io::ErrorKind::InvalidInput, e))
+}
+
+/// A file parsed by [`parse_path`]: its bytes and its tree.
+pub struct ParsedPath {
+    pub source: MappedFile,
+    pub tree: Tree,
+}
+
+/// Maps the file at `path` and parses it with `parser`.
+///
+/// Each read of the parser gets the rest of the mapping from the requested
+/// offset, so no chunk boundary ever splits a character.
+pub fn parse_path(parser: &mut Parser, path: impl AsRef<Path>) -> io::Result<ParsedPath> {
+    let source = MappedFile::open(path)?;
+    let bytes: &[u8] = &source;
+    let tree = parser
+        .parse_with_options(&mut |offset, _| &bytes[offset.min(bytes.len())..], None, None)
+        .ok_or_else(|| io::Error::other("parser has no language"))?;
+    Ok(ParsedPath { source, tree })
+}
@@ -0,0 +1,128 @@
+//! Top-level outline of a tree in one pass (feature `outline`).
+//!
+//! [`outline`] runs `bindings/c/outline.c` over the children of the root:
+//! functions, natives, types and globals, with the byte ranges of their
+//! names and signatures. Function bodies are never entered, so an outline
+//! costs as much as the number of top-level declarations. Entries are
+//! plain `Copy` records written into a reusable `Vec`.
+//!
+//! ```no_run
+//! # let (tree, source): (tree_sitter::Tree, &[u8]) = unimplemented!();
+//! let mut entries = Vec::new();
+//! tree_sitter_jass::outline(&tree, &mut entries);
+//! for entry in &entries {
+//!     println!("{:?} {} at {}", entry.kind(), entry.name(source), entry.start_position().row);
+//! }
+//! ```
+
+use std::ops::Range;
+
+use tree_sitter::{Point, Tree, ffi::TSNode};
+
+use crate::SymbolKind;
+
+unsafe extern "C" {
+    fn jass_outline(root: TSNode, entries: *mut OutlineEntry, capacity: usize) -> usize;
+}
+
+const CONSTANT: u8 = 1 << 0;
+const ARRAY: u8 = 1 << 1;
+
+/// One top-level declaration; ranges are byte offsets into the source.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct OutlineEntry {
+    kind: u8,
+    flags: u8,
+    reserved: u16,
+    start_byte: u32,
+    end_byte: u32,
+    start_row: u32,
+    start_column: u32,
+    name_start: u32,
+    name_end: u32,
+    type_start: u32,
+    type_end: u32,
+    parameters_start: u32,
+    parameters_end: u32,
+}
+
+impl OutlineEntry {
+    pub fn kind(&self) -> SymbolKind {
+        match self.kind {
+            0 => SymbolKind::Function,
+            1 => SymbolKind::Native,
+            2 => SymbolKind::Type,
+            _ => SymbolKind::Global,
+        }
+    }
+
+    pub fn constant(&self) -> bool {
+        self.flags & CONSTANT != 0
+    }
+
+    pub fn array(&self) -> bool {
+        self.flags & ARRAY != 0
+    }
+
+    /// The whole declaration (for a global, its `var_decl`).
+    pub fn byte_range(&self) -> Range<usize> {
+        self.start_byte as usize..self.end_byte as usize
+    }
+
+    pub fn start_position(&self) -> Point {
+        Point::new(self.start_row as usize, self.start_column as usize)
+    }
+
+    pub fn name_range(&self) -> Range<usize> {
+        self.name_start as usize..self.name_end as usize
+    }
+
+    /// Return type of functions and natives, base of types, variable type
+    /// of globals; empty if absent.
+    pub fn type_range(&self) -> Range<usize> {
+        self.type_start as usize..self.type_end as usize
+    }
+
+    /// `nothing` or the parameter list; empty for types and globals.
+    pub fn parameters_range(&self) -> Range<usize> {
+        self.parameters_start as usize..self.parameters_end as usize
+    }
+
+    /// The name, read from the source the tree was parsed from.
+    pub fn name<'s>(&self, source: &'s [u8]) -> &'s str {
+        text(source, self.name_range())
+    }
+
+    pub fn type_name<'s>(&self, source: &'s [u8]) -> &'s str {
+        text(source, self.type_range())
+    }
+
+    pub fn parameters<'s>(&self, source: &'s [u8]) -> &'s str {
+        text(source, self.parameters_range())
+    }
+}
+
+fn text(source: &[u8], range: Range<usize>) -> &str {
+    source.get(range).and_then(|bytes| std::str::from_utf8(bytes).ok()).unwrap_or("")
+}
+
+/// Replaces the contents of `entries` with the top-level declarations of
+/// `tree`, in source order. Reusing one `Vec` across calls avoids any
+/// allocation once it is large enough.
+pub fn outline(tree: &Tree, entries: &mut Vec<OutlineEntry>) {
+    let root = tree.root_node().into_raw();
+    entries.clear();
+    // One entry per top-level node is a good first guess: globals blocks
+    // are the only ones with more
+    entries.reserve(tree.root_node().named_child_count());
+    loop {
+        let capacity = entries.capacity();
+        let count = unsafe { jass_outline(root, entries.as_mut_ptr(), capacity) };
+        if count <= capacity {
+            unsafe { entries.set_len(count) };
+            return;
+        }
+        entries.reserve(count);
+    }
+}
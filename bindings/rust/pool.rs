@@ -0,0 +1,149 @@
+//! Parallel parsing on a pool of reusable parsers (feature `pool`).
+//!
+//! [`ParserPool`] hands out parsers already configured for one JASS grammar
+//! and takes them back when dropped, so a long batch reuses a handful of
+//! parser allocations instead of creating one per file. [`ParserPool::parse_sources`]
+//! and [`ParserPool::parse_files`] fan a batch out over the rayon thread pool.
+//!
+//! ```no_run
+//! let pool = std::sync::Arc::new(tree_sitter_jass::ParserPool::new(tree_sitter_jass::language()));
+//! let paths = vec!["war3map.j".into(), "Blizzard.j".into()];
+//! for file in pool.parse_files(paths) {
+//!     match file.parsed {
+//!         Ok(parsed) => println!("{}: {}", file.path.display(), parsed.tree.root_node().has_error()),
+//!         Err(error) => eprintln!("{}: {}", file.path.display(), error),
+//!     }
+//! }
+//! ```
+
+use std::ops::{Deref, DerefMut};
+use std::path::PathBuf;
+use std::sync::mpsc::{self, Receiver};
+use std::sync::{Arc, Mutex};
+
+use rayon::prelude::*;
+use tree_sitter::{Language, Parser, Tree};
+use tree_sitter_language::LanguageFn;
+
+/// A thread-safe pool of parsers for one grammar.
+pub struct ParserPool {
+    language: Language,
+    idle: Mutex<Vec<Parser>>,
+}
+
+impl ParserPool {
+    /// Creates an empty pool; parsers are created on first use.
+    pub fn new(language: LanguageFn) -> Self {
+        Self {
+            language: language.into(),
+            idle: Mutex::new(Vec::new()),
+        }
+    }
+
+    /// The grammar every parser of this pool is configured for.
+    pub fn language(&self) -> &Language {
+        &self.language
+    }
+
+    /// Takes an idle parser, or creates one. It returns to the pool on drop.
+    pub fn get(&self) -> PooledParser<'_> {
+        let parser = self.idle.lock().unwrap().pop().unwrap_or_else(|| {
+            let mut parser = Parser::new();
+            parser
+                .set_language(&self.language)
+                .expect("Error loading JASS grammar");
+            parser
+        });
+        PooledParser {
+            pool: self,
+            parser: Some(parser),
+        }
+    }
+
+    /// Parses every source in parallel; trees are returned in input order.
+    pub fn parse_sources<S>(&self, sources: &[S]) -> Vec<Tree>
+    where
+        S: AsRef<[u8]> + Sync,
+    {
+        sources
+            .par_iter()
+            .map_init(|| self.get(), |parser, source| parse(parser, source.as_ref()))
+            .collect()
+    }
+
+    /// Reads and parses every file on the rayon thread pool. Results are
+    /// sent as soon as each file is done, so they arrive in completion order;
+    /// [`ParsedFile::index`] is the position in `paths`. The iterator ends
+    /// when the whole batch is done.
+    pub fn parse_files(self: &Arc<Self>, paths: Vec<PathBuf>) -> Receiver<ParsedFile> {
+        let (sender, receiver) = mpsc::channel();
+        let pool = Arc::clone(self);
+        rayon::spawn(move || {
+            paths.into_par_iter().enumerate().for_each_init(
+                || (pool.get(), sender.clone()),
+                |(parser, sender), (index, path)| {
+                    let parsed = std::fs::read(&path).map(|source| {
+                        let tree = parse(parser, &source);
+                        Parsed { source, tree }
+                    });
+                    // The receiver may be gone; the rest of the batch is then wasted work
+                    let _ = sender.send(ParsedFile {
+                        index,
+                        path,
+                        parsed,
+                    });
+                },
+            );
+        });
+        receiver
+    }
+}
+
+fn parse(parser: &mut Parser, source: &[u8]) -> Tree {
+    parser
+        .parse(source, None)
+        .expect("parser has a language and no cancellation")
+}
+
+/// A parser borrowed from a [`ParserPool`].
+pub struct PooledParser<'p> {
+    pool: &'p ParserPool,
+    parser: Option<Parser>,
+}
+
+impl Deref for PooledParser<'_> {
+    type Target = Parser;
+
+    fn deref(&self) -> &Parser {
+        self.parser.as_ref().unwrap()
+    }
+}
+
+impl DerefMut for PooledParser<'_> {
+    fn deref_mut(&mut self) -> &mut Parser {
+        self.parser.as_mut().unwrap()
+    }
+}
+
+impl Drop for PooledParser<'_> {
+    fn drop(&mut self) {
+        if let Some(mut parser) = self.parser.take() {
+            // Drop any half-finished parse state before another caller gets it
+            parser.reset();
+            self.pool.idle.lock().unwrap().push(parser);
+        }
+    }
+}
+
+/// One result of [`ParserPool::parse_files`].
+pub struct ParsedFile {
+    pub index: usize,
+    pub path: PathBuf,
+    pub parsed: std::io::Result<Parsed>,
+}
+
+/// A source together with its tree.
+pub struct Parsed {
+    pub source: Vec<u8>,
+    pub tree: Tree,
+}
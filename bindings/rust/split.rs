@@ -0,0 +1,180 @@
+//! Parallel parsing of one large source (feature `pool`).
+//!
+//! [`ParserPool::parse_split`] cuts a source at top-level declaration
+//! boundaries with the C pre-scanner of `bindings/c/split.c` and parses the
+//! chunks on the rayon thread pool. Each chunk is parsed as the only
+//! included range of the whole source, so node offsets and points are
+//! those of the file. When the structure doesn't allow a safe cut (see
+//! `split.h`) the source is parsed as a whole and [`SplitTree::fell_back`]
+//! is set.
+//!
+//! ```no_run
+//! let pool = tree_sitter_jass::ParserPool::new(tree_sitter_jass::language());
+//! let source = std::fs::read("war3map.j").unwrap();
+//! let split = pool.parse_split(&source, 512 << 10);
+//! for symbol in &split.symbols {
+//!     println!("{:?} {} at {}", symbol.kind, symbol.name, symbol.byte_range.start);
+//! }
+//! ```
+
+use std::ffi::c_char;
+
+use rayon::prelude::*;
+use tree_sitter::{Node, Point, Range, Tree};
+
+use crate::{ParserPool, SymbolKind};
+
+#[repr(C)]
+struct RawChunk {
+    start_row: u32,
+    start_column: u32,
+    end_row: u32,
+    end_column: u32,
+    start_byte: u32,
+    end_byte: u32,
+}
+
+unsafe extern "C" {
+    fn jass_split(
+        source: *const c_char,
+        length: u32,
+        target_size: u32,
+        chunks: *mut *mut RawChunk,
+        ambiguous: *mut bool,
+    ) -> usize;
+    fn jass_split_free(chunks: *mut RawChunk);
+}
+
+/// Chunk ranges of `source`, each at least `target_size` bytes except the
+/// last, and whether the pre-scan had to fall back to one chunk.
+fn split(source: &[u8], target_size: usize) -> (Vec<Range>, bool) {
+    let length = u32::try_from(source.len()).expect("tree-sitter sources are limited to 4 GiB");
+    let target_size = u32::try_from(target_size).unwrap_or(u32::MAX);
+    let mut raw = std::ptr::null_mut();
+    let mut ambiguous = false;
+    let count = unsafe {
+        jass_split(source.as_ptr().cast(), length, target_size, &mut raw, &mut ambiguous)
+    };
+    assert!(count > 0, "out of memory");
+    let ranges = unsafe { std::slice::from_raw_parts(raw, count) }
+        .iter()
+        .map(|chunk| Range {
+            start_byte: chunk.start_byte as usize,
+            end_byte: chunk.end_byte as usize,
+            start_point: Point::new(chunk.start_row as usize, chunk.start_column as usize),
+            end_point: Point::new(chunk.end_row as usize, chunk.end_column as usize),
+        })
+        .collect();
+    unsafe { jass_split_free(raw) };
+    (ranges, ambiguous)
+}
+
+/// The result of [`ParserPool::parse_split`].
+pub struct SplitTree {
+    /// Chunk trees in source order
+    pub chunks: Vec<ParsedChunk>,
+    /// Top-level declarations of all chunks, in source order
+    pub symbols: Vec<Symbol>,
+    /// The source could not be split safely and was parsed as one chunk
+    pub fell_back: bool,
+}
+
+/// One chunk of a [`SplitTree`]: its byte and point range in the source
+/// and its tree, whose nodes carry offsets into the whole source.
+pub struct ParsedChunk {
+    pub range: Range,
+    pub tree: Tree,
+}
+
+/// A top-level declaration: function, native, type or global variable.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct Symbol {
+    pub kind: SymbolKind,
+    pub name: String,
+    /// The whole declaration (for globals, the variable declaration)
+    pub byte_range: std::ops::Range<usize>,
+}
+
+fn push_symbol(symbols: &mut Vec<Symbol>, kind: SymbolKind, node: Node, source: &[u8]) {
+    if let Some(name) = node.child_by_field_name("name") {
+        symbols.push(Symbol {
+            kind,
+            name: String::from_utf8_lossy(&source[name.byte_range()]).into_owned(),
+            byte_range: node.byte_range(),
+        });
+    }
+}
+
+fn collect_symbols(tree: &Tree, source: &[u8]) -> Vec<Symbol> {
+    let mut symbols = Vec::new();
+    let root = tree.root_node();
+    let mut cursor = root.walk();
+    for node in root.named_children(&mut cursor) {
+        match node.kind() {
+            "function_statement" => push_symbol(&mut symbols, SymbolKind::Function, node, source),
+            "native_statement" => push_symbol(&mut symbols, SymbolKind::Native, node, source),
+            "type_statement" => push_symbol(&mut symbols, SymbolKind::Type, node, source),
+            "globals" => {
+                let mut globals = node.walk();
+                for declaration in node.named_children(&mut globals) {
+                    if declaration.kind() != "var_stmt" {
+                        continue;
+                    }
+                    let mut decls = declaration.walk();
+                    for decl in declaration.named_children(&mut decls) {
+                        if decl.kind() == "var_decl" {
+                            push_symbol(&mut symbols, SymbolKind::Global, decl, source);
+                        }
+                    }
+                }
+            }
+            _ => {}
+        }
+    }
+    symbols
+}
+
+impl ParserPool {
+    /// Parses one source in chunks of about `chunk_size` bytes, cut at
+    /// top-level declarations, in parallel. A small `chunk_size` gives more
+    /// parallelism; `source.len() / (4 * threads)` is a good start.
+    pub fn parse_split(&self, source: &[u8], chunk_size: usize) -> SplitTree {
+        let (ranges, fell_back) = split(source, chunk_size);
+        let whole = ranges.len() == 1;
+        let parsed: Vec<(ParsedChunk, Vec<Symbol>)> = ranges
+            .into_par_iter()
+            .map_init(
+                || self.get(),
+                |parser, range| {
+                    // A single chunk is the whole source: no ranges needed
+                    if !whole {
+                        parser
+                            .set_included_ranges(&[range])
+                            .expect("chunks are ordered and disjoint");
+                    }
+                    let tree = parser
+                        .parse(source, None)
+                        .expect("parser has a language and no cancellation");
+                    if !whole {
+                        // Pooled parsers are handed out without ranges
+                        parser.set_included_ranges(&[]).unwrap();
+                    }
+                    let symbols = collect_symbols(&tree, source);
+                    (ParsedChunk { range, tree }, symbols)
+                },
+            )
+            .collect();
+
+        let mut chunks = Vec::with_capacity(parsed.len());
+        let mut symbols = Vec::new();
+        for (chunk, chunk_symbols) in parsed {
+            chunks.push(chunk);
+            symbols.extend(chunk_symbols);
+        }
+        SplitTree {
+            chunks,
+            symbols,
+            fell_back,
+        }
+    }
+}
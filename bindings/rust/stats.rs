@@ -0,0 +1,57 @@
+//! Scanner instrumentation counters (feature `scanner-stats`).
+//!
+//! With the feature the external scanners are compiled with
+//! `JASS_SCANNER_STATS` and count their work per thread; see
+//! `common/scanner_stats.h`. Without it the counters don't exist and these
+//! functions return `None`.
+//!
+//! ```
+//! let mut parser = tree_sitter::Parser::new();
+//! parser.set_language(&tree_sitter_jass::language().into()).unwrap();
+//! tree_sitter_jass::scanner_stats(true);
+//! parser.parse("globals\nendglobals\n", None).unwrap();
+//! if let Some(stats) = tree_sitter_jass::scanner_stats(false) {
+//!     assert!(stats.invocations > 0);
+//! }
+//! ```
+
+/// Counters of one grammar's external scanner on the calling thread.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct ScannerStats {
+    /// Calls of the external scanner
+    pub invocations: u64,
+    /// Calls during error recovery, when every external token is valid
+    pub error_recovery: u64,
+    /// Tokens emitted, indexed like the grammar externals: comment,
+    /// string content, escape sequence, rawcode, identifier, the four
+    /// virtual closes (endloop, endglobals, endfunction, endif) and, in
+    /// `jass_decls`, function_body
+    pub tokens: [u64; 10],
+    /// Characters advanced over, peeks included
+    pub advanced: u64,
+    /// Whitespace characters skipped
+    pub skipped: u64,
+    /// Words read to decide on a virtual close that didn't emit one
+    pub word_peeks: u64,
+    /// Words read that turned out to be identifiers
+    pub keyword_misses: u64,
+}
+
+unsafe extern "C" {
+    fn tree_sitter_jass_scanner_stats(out: *mut ScannerStats, reset: bool) -> bool;
+}
+
+fn read(
+    accessor: unsafe extern "C" fn(*mut ScannerStats, bool) -> bool,
+    reset: bool,
+) -> Option<ScannerStats> {
+    let mut stats = ScannerStats::default();
+    unsafe { accessor(&mut stats, reset) }.then_some(stats)
+}
+
+/// This thread's scanner counters of the base grammar, zeroed afterwards
+/// if `reset`. `None` without the `scanner-stats` feature.
+pub fn scanner_stats(reset: bool) -> Option<ScannerStats> {
+    read(tree_sitter_jass_scanner_stats, reset)
+}
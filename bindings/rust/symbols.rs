@@ -0,0 +1,411 @@
+//! On-disk symbol tables of top-level declarations (feature `symbols`).
+//!
+//! A [`SymbolTable`] holds the functions, natives, types and globals of one
+//! source in the compact format of `bindings/c/symtab.h`, keyed by a hash
+//! of the source bytes and the grammar it was extracted with.
+//! [`SymbolCache`] keeps one table file per source and grammar variant in a
+//! directory: loading an unchanged `common.j`, `Blizzard.j` or map header
+//! maps its table instead of parsing the file again.
+//!
+//! ```no_run
+//! let mut parser = tree_sitter::Parser::new();
+//! parser.set_language(&tree_sitter_jass::language().into()).unwrap();
+//! let cache = tree_sitter_jass::SymbolCache::new("target/jass-symbols");
+//! let common = cache.load(&mut parser, "common.j").unwrap();
+//! let native = common.find("GetUnitX").unwrap();
+//! println!("{} takes {} returns {}", native.name, native.parameters, native.type_name);
+//! ```
+
+use std::ffi::{CStr, CString, c_char};
+use std::io;
+use std::ops::Range;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU32, Ordering};
+
+use tree_sitter::{Language, Node, Parser, Point, Tree};
+
+use crate::{MappedFile, SymbolKind};
+
+const CONSTANT: u8 = 1 << 0;
+const ARRAY: u8 = 1 << 1;
+
+#[repr(C)]
+struct RawSymbolInput {
+    kind: u8,
+    flags: u8,
+    name: *const c_char,
+    name_length: u32,
+    type_name: *const c_char,
+    type_length: u32,
+    parameters: *const c_char,
+    parameters_length: u32,
+    start_byte: u32,
+    end_byte: u32,
+    start_row: u32,
+    start_column: u32,
+}
+
+#[repr(C)]
+struct RawSymbol {
+    kind: u8,
+    flags: u8,
+    name: *const c_char,
+    type_name: *const c_char,
+    parameters: *const c_char,
+    start_byte: u32,
+    end_byte: u32,
+    start_row: u32,
+    start_column: u32,
+}
+
+#[repr(C)]
+struct RawSymtab {
+    data: *const u8,
+    length: usize,
+    source_hash: u64,
+    source_length: u32,
+    count: u32,
+    abi_version: u32,
+    grammar_hash: u64,
+}
+
+unsafe extern "C" {
+    fn jass_symtab_hash(source: *const c_char, length: u32) -> u64;
+    fn jass_symtab_build(
+        source_hash: u64,
+        source_length: u32,
+        grammar: *const c_char,
+        abi_version: u32,
+        symbols: *const RawSymbolInput,
+        count: usize,
+        data: *mut *mut u8,
+        length: *mut usize,
+    ) -> bool;
+    fn jass_symtab_free(data: *mut u8);
+    fn jass_symtab_open(data: *const u8, length: usize, table: *mut RawSymtab) -> bool;
+    fn jass_symtab_get(table: *const RawSymtab, index: u32, symbol: *mut RawSymbol);
+    fn jass_symtab_find(table: *const RawSymtab, name: *const c_char, length: usize) -> i64;
+}
+
+/// A top-level declaration stored in a [`SymbolTable`].
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct Declaration<'t> {
+    pub kind: SymbolKind,
+    pub name: &'t str,
+    /// Return type of functions and natives, base of types, variable type
+    /// of globals
+    pub type_name: &'t str,
+    /// Parameter list (`nothing` or `unit u, real x`); empty for types and
+    /// globals
+    pub parameters: &'t str,
+    pub constant: bool,
+    pub array: bool,
+    pub byte_range: Range<usize>,
+    pub start_position: Point,
+}
+
+enum Bytes {
+    Owned(Vec<u8>),
+    Mapped(MappedFile),
+}
+
+impl Bytes {
+    fn as_slice(&self) -> &[u8] {
+        match self {
+            Bytes::Owned(bytes) => bytes,
+            Bytes::Mapped(file) => file,
+        }
+    }
+}
+
+/// The serialized symbol table of one source.
+pub struct SymbolTable {
+    bytes: Bytes,
+    raw: RawSymtab,
+}
+
+// `raw` only points into `bytes`, which is never written
+unsafe impl Send for SymbolTable {}
+unsafe impl Sync for SymbolTable {}
+
+impl SymbolTable {
+    /// Builds the table of `source` from its tree (any grammar variant).
+    pub fn from_tree(tree: &Tree, source: &[u8]) -> SymbolTable {
+        let inputs = collect(tree, source);
+        let length = u32::try_from(source.len()).expect("tree-sitter sources are limited to 4 GiB");
+        let hash = hash(source);
+        let language = tree.language();
+        let grammar = CString::new(grammar_name(&language)).unwrap_or_default();
+        let mut data = std::ptr::null_mut();
+        let mut size = 0;
+        let built = unsafe {
+            jass_symtab_build(
+                hash,
+                length,
+                grammar.as_ptr(),
+                language.abi_version() as u32,
+                inputs.as_ptr(),
+                inputs.len(),
+                &mut data,
+                &mut size,
+            )
+        };
+        assert!(built, "out of memory");
+        let bytes = unsafe { std::slice::from_raw_parts(data, size) }.to_vec();
+        unsafe { jass_symtab_free(data) };
+        SymbolTable::from_bytes(bytes).expect("a freshly built table is valid")
+    }
+
+    /// Validates a serialized table; `None` if it isn't one of this version.
+    pub fn from_bytes(bytes: Vec<u8>) -> Option<SymbolTable> {
+        SymbolTable::new(Bytes::Owned(bytes))
+    }
+
+    /// Maps a table file; `Ok(None)` if the file isn't a valid table.
+    pub fn open(path: impl AsRef<Path>) -> io::Result<Option<SymbolTable>> {
+        Ok(SymbolTable::new(Bytes::Mapped(MappedFile::open(path)?)))
+    }
+
+    fn new(bytes: Bytes) -> Option<SymbolTable> {
+        let mut raw = RawSymtab {
+            data: std::ptr::null(),
+            length: 0,
+            source_hash: 0,
+            source_length: 0,
+            count: 0,
+            abi_version: 0,
+            grammar_hash: 0,
+        };
+        let slice = bytes.as_slice();
+        unsafe { jass_symtab_open(slice.as_ptr(), slice.len(), &mut raw) }.then_some(SymbolTable { bytes, raw })
+    }
+
+    /// The serialized table, as written to a cache file.
+    pub fn as_bytes(&self) -> &[u8] {
+        self.bytes.as_slice()
+    }
+
+    /// Whether the table was mapped from a file rather than built or read.
+    pub fn is_mapped(&self) -> bool {
+        matches!(self.bytes, Bytes::Mapped(_))
+    }
+
+    /// Hash of the source the table was built from (64-bit FNV-1a).
+    pub fn source_hash(&self) -> u64 {
+        self.raw.source_hash
+    }
+
+    pub fn source_len(&self) -> usize {
+        self.raw.source_length as usize
+    }
+
+    /// ABI version of the language the table was extracted with.
+    pub fn abi_version(&self) -> usize {
+        self.raw.abi_version as usize
+    }
+
+    /// Hash of the name of the language the table was extracted with.
+    pub fn grammar_hash(&self) -> u64 {
+        self.raw.grammar_hash
+    }
+
+    /// Whether the table was extracted with `language`: the same grammar
+    /// variant at the same ABI version.
+    pub fn is_for(&self, language: &Language) -> bool {
+        self.abi_version() == language.abi_version() && self.grammar_hash() == hash(grammar_name(language).as_bytes())
+    }
+
+    pub fn len(&self) -> usize {
+        self.raw.count as usize
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.raw.count == 0
+    }
+
+    /// The declaration at `index`, in source order.
+    pub fn get(&self, index: usize) -> Option<Declaration<'_>> {
+        if index >= self.len() {
+            return None;
+        }
+        let mut raw = std::mem::MaybeUninit::<RawSymbol>::uninit();
+        let raw = unsafe {
+            jass_symtab_get(&self.raw, index as u32, raw.as_mut_ptr());
+            raw.assume_init()
+        };
+        Some(Declaration {
+            kind: match raw.kind {
+                0 => SymbolKind::Function,
+                1 => SymbolKind::Native,
+                2 => SymbolKind::Type,
+                _ => SymbolKind::Global,
+            },
+            name: unsafe { text(raw.name) },
+            type_name: unsafe { text(raw.type_name) },
+            parameters: unsafe { text(raw.parameters) },
+            constant: raw.flags & CONSTANT != 0,
+            array: raw.flags & ARRAY != 0,
+            byte_range: raw.start_byte as usize..raw.end_byte as usize,
+            start_position: Point::new(raw.start_row as usize, raw.start_column as usize),
+        })
+    }
+
+    pub fn iter(&self) -> impl ExactSizeIterator<Item = Declaration<'_>> + '_ {
+        (0..self.len()).map(|index| self.get(index).unwrap())
+    }
+
+    /// Looks a name up in the sorted name index; with duplicates, the
+    /// first declaration in source order.
+    pub fn find(&self, name: &str) -> Option<Declaration<'_>> {
+        let index = unsafe { jass_symtab_find(&self.raw, name.as_ptr().cast(), name.len()) };
+        usize::try_from(index).ok().and_then(|index| self.get(index))
+    }
+}
+
+// Stored strings are source text: identifiers and parameter lists that are
+// UTF-8 in practice; anything else reads as empty
+unsafe fn text<'t>(ptr: *const c_char) -> &'t str {
+    unsafe { CStr::from_ptr(ptr) }.to_str().unwrap_or("")
+}
+
+// Generated languages are named `jass`, `jass_chain`, ...; older ABIs have
+// no name and share one
+fn grammar_name(language: &Language) -> &str {
+    language.name().unwrap_or("")
+}
+
+fn hash(source: &[u8]) -> u64 {
+    unsafe { jass_symtab_hash(source.as_ptr().cast(), source.len() as u32) }
+}
+
+fn input(kind: SymbolKind, flags: u8, node: Node, name: Node, type_name: Option<Node>, parameters: Option<Node>, source: &[u8]) -> RawSymbolInput {
+    let span = |node: Option<Node>| match node {
+        Some(node) => (source[node.start_byte()..].as_ptr().cast(), (node.end_byte() - node.start_byte()) as u32),
+        None => (std::ptr::null(), 0),
+    };
+    let (name, name_length) = span(Some(name));
+    let (type_name, type_length) = span(type_name);
+    let (parameters, parameters_length) = span(parameters);
+    let start = node.start_position();
+    RawSymbolInput {
+        kind: kind as u8,
+        flags,
+        name,
+        name_length,
+        type_name,
+        type_length,
+        parameters,
+        parameters_length,
+        start_byte: node.start_byte() as u32,
+        end_byte: node.end_byte() as u32,
+        start_row: start.row as u32,
+        start_column: start.column as u32,
+    }
+}
+
+fn collect(tree: &Tree, source: &[u8]) -> Vec<RawSymbolInput> {
+    let mut inputs = Vec::new();
+    let root = tree.root_node();
+    let mut cursor = root.walk();
+    for node in root.named_children(&mut cursor) {
+        let constant = node.child(0).is_some_and(|first| first.kind() == "constant");
+        let flags = if constant { CONSTANT } else { 0 };
+        let name = node.child_by_field_name("name");
+        match (node.kind(), name) {
+            ("function_statement", Some(name)) | ("native_statement", Some(name)) => {
+                let kind = if node.kind() == "native_statement" { SymbolKind::Native } else { SymbolKind::Function };
+                let returns = node.child_by_field_name("return_type");
+                let parameters = node.child_by_field_name("parameters");
+                inputs.push(input(kind, flags, node, name, returns, parameters, source));
+            }
+            ("type_statement", Some(name)) => {
+                let base = node.child_by_field_name("base");
+                inputs.push(input(SymbolKind::Type, 0, node, name, base, None, source));
+            }
+            ("globals", _) => {
+                let mut statements = node.walk();
+                for statement in node.named_children(&mut statements) {
+                    if statement.kind() != "var_stmt" {
+                        continue;
+                    }
+                    let mut flags = 0;
+                    let mut children = statement.walk();
+                    for child in statement.children(&mut children) {
+                        match child.kind() {
+                            "constant" => flags |= CONSTANT,
+                            "array" => flags |= ARRAY,
+                            _ => {}
+                        }
+                    }
+                    let type_name = statement.child_by_field_name("type");
+                    let mut decls = statement.walk();
+                    for decl in statement.named_children(&mut decls) {
+                        if let ("var_decl", Some(name)) = (decl.kind(), decl.child_by_field_name("name")) {
+                            inputs.push(input(SymbolKind::Global, flags, decl, name, type_name, None, source));
+                        }
+                    }
+                }
+            }
+            _ => {}
+        }
+    }
+    inputs
+}
+
+/// A directory of symbol tables, one `<hash>.<grammar>.jsym` file per
+/// source and grammar variant (`0123456789abcdef.jass.jsym`).
+pub struct SymbolCache {
+    dir: PathBuf,
+}
+
+impl SymbolCache {
+    pub fn new(dir: impl Into<PathBuf>) -> SymbolCache {
+        SymbolCache { dir: dir.into() }
+    }
+
+    /// The table of the file at `path`: mapped from the cache when the file
+    /// is unchanged, otherwise parsed with `parser` and stored.
+    pub fn load(&self, parser: &mut Parser, path: impl AsRef<Path>) -> io::Result<SymbolTable> {
+        let source = MappedFile::open(path)?;
+        self.load_source(parser, &source)
+    }
+
+    /// Like [`load`](Self::load) for a source in memory, e.g. an open
+    /// editor buffer.
+    pub fn load_source(&self, parser: &mut Parser, source: &[u8]) -> io::Result<SymbolTable> {
+        let language = parser
+            .language()
+            .ok_or_else(|| io::Error::other("parser has no language"))?;
+        let hash = hash(source);
+        let path = self.dir.join(format!("{hash:016x}.{}.jsym", grammar_name(&language)));
+        // A missing, stale, corrupt or foreign file is rebuilt
+        if let Ok(Some(table)) = SymbolTable::open(&path) {
+            if table.source_hash() == hash && table.source_len() == source.len() && table.is_for(&language) {
+                return Ok(table);
+            }
+        }
+
+        let tree = parser
+            .parse(source, None)
+            .ok_or_else(|| io::Error::other("parser has no language"))?;
+        let table = SymbolTable::from_tree(&tree, source);
+        self.store(&path, table.as_bytes())?;
+        Ok(table)
+    }
+
+    // Written under a unique name and renamed, so concurrent loaders never
+    // map a partial file
+    fn store(&self, path: &Path, bytes: &[u8]) -> io::Result<()> {
+        static NEXT: AtomicU32 = AtomicU32::new(0);
+        std::fs::create_dir_all(&self.dir)?;
+        let temporary = path.with_extension(format!(
+            "{}-{}.tmp",
+            std::process::id(),
+            NEXT.fetch_add(1, Ordering::Relaxed)
+        ));
+        std::fs::write(&temporary, bytes)?;
+        std::fs::rename(&temporary, path).inspect_err(|_| {
+            let _ = std::fs::remove_file(&temporary);
+        })
+    }
+}
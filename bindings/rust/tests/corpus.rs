@@ -0,0 +1,398 @@
+//! Parallel corpus runner with per-input timing.
+//!
+//! Parses every entry of `test/corpus/*.txt` and compares its S-expression
+//! with the expected tree, as `tree-sitter test` does. It then times a
+//! parse of every whole input: each corpus file, the inputs of the
+//! benchmark corpus (examples, generated maps) and every `.j`/`.jass` file
+//! under `$JASS_BENCH_CORPUS`. All of it runs on a thread per CPU.
+//!
+//! ```sh
+//! cargo test --release --test corpus
+//! cargo test --release --test corpus -- statements map-100k   # only matching inputs
+//! JASS_BENCH_CORPUS=path/to/maps cargo test --release --test corpus
+//! JASS_CORPUS_BASELINE=target/corpus-baseline.tsv cargo test --release --test corpus -- --update-baseline
+//! JASS_CORPUS_BASELINE=target/corpus-baseline.tsv cargo test --release --test corpus
+//! ```
+//!
+//! With `JASS_CORPUS_BASELINE`, each input's parse time is compared with
+//! the time stored for it there, and the run fails if an input became more
+//! than `JASS_CORPUS_THRESHOLD` times slower (default 2) and at least
+//! `MIN_REGRESSION` slower in absolute terms, so timer noise on tiny
+//! inputs does not fail it. `--update-baseline` writes the file instead.
+//! Baselines hold wall times, so only compare runs of the same build
+//! profile on the same machine; `JASS_CORPUS_THREADS=1` makes the timings
+//! steadier at the cost of a slower run.
+
+#[path = "../benches/corpus.rs"]
+mod corpus;
+
+use std::collections::HashMap;
+use std::path::{Path, PathBuf};
+use std::process::ExitCode;
+use std::sync::Mutex;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+
+use tree_sitter::{Parser, Tree};
+use tree_sitter_language::LanguageFn;
+
+/// Timed parses per input; the fastest one is reported.
+const RUNS: usize = 3;
+/// Slowdowns smaller than this never count as a regression.
+const MIN_REGRESSION: Duration = Duration::from_millis(1);
+
+/// Corpus directories to check. Only the default grammar has a committed
+/// parser; the variants' corpora join once theirs are generated.
+fn corpora() -> Vec<(&'static str, &'static str, LanguageFn)> {
+    vec![("jass", "test/corpus", tree_sitter_jass::language())]
+}
+
+/// One test of a corpus file.
+struct Entry {
+    name: String,
+    input: String,
+    expected: String,
+    skip: bool,
+    error: bool,
+}
+
+/// Splits a corpus file into its entries: a title between two `===` lines,
+/// optional `:skip` / `:error` attributes, the input, a `---` line and the
+/// expected tree.
+fn parse_corpus(text: &str) -> Vec<Entry> {
+    fn is_rule(line: &str, c: char) -> bool {
+        let line = line.trim_end();
+        line.len() >= 3 && line.chars().all(|x| x == c)
+    }
+
+    let lines: Vec<&str> = text.lines().collect();
+    let mut entries = Vec::new();
+    let mut i = 0;
+    while i < lines.len() {
+        if !is_rule(lines[i], '=') {
+            i += 1;
+            continue;
+        }
+        i += 1;
+        let mut name = Vec::new();
+        let (mut skip, mut error) = (false, false);
+        while i < lines.len() && !is_rule(lines[i], '=') {
+            match lines[i].trim() {
+                ":skip" => skip = true,
+                ":error" => error = true,
+                line if line.starts_with(':') => {}
+                line => name.push(line),
+            }
+            i += 1;
+        }
+        i += 1;
+
+        let input_start = i;
+        while i < lines.len() && !is_rule(lines[i], '-') {
+            i += 1;
+        }
+        let input = lines[input_start..i.min(lines.len())].join("\n");
+        i += 1;
+
+        // The expected tree runs up to the `===` line of the next entry
+        let expected_start = i.min(lines.len());
+        let next_header = |i: usize| {
+            is_rule(lines[i], '=') && lines.get(i + 1).is_some_and(|title| !title.trim().is_empty())
+        };
+        while i < lines.len() && !next_header(i) {
+            i += 1;
+        }
+        entries.push(Entry {
+            name: name.join(" "),
+            input: input.trim_end_matches('\n').to_string() + "\n",
+            expected: normalize(&lines[expected_start..i].join("\n")),
+            skip,
+            error,
+        });
+    }
+    entries
+}
+
+/// Collapses whitespace so the expected and actual trees compare as text.
+fn normalize(sexp: &str) -> String {
+    let collapsed = sexp.split_whitespace().collect::<Vec<_>>().join(" ");
+    collapsed.replace(" )", ")").replace("( ", "(")
+}
+
+fn count_nodes(tree: &Tree) -> usize {
+    let mut cursor = tree.walk();
+    let mut nodes = 0;
+    loop {
+        nodes += 1;
+        if cursor.goto_first_child() || cursor.goto_next_sibling() {
+            continue;
+        }
+        loop {
+            if !cursor.goto_parent() {
+                return nodes;
+            }
+            if cursor.goto_next_sibling() {
+                break;
+            }
+        }
+    }
+}
+
+/// Something to check and time on one thread.
+enum Job {
+    Corpus {
+        grammar: &'static str,
+        path: PathBuf,
+        language: LanguageFn,
+    },
+    Source {
+        name: String,
+        source: String,
+    },
+}
+
+struct Report {
+    name: String,
+    bytes: usize,
+    nodes: usize,
+    time: Duration,
+    /// One line per corpus entry whose tree differs from the expected one
+    failures: Vec<String>,
+}
+
+/// Fastest of `RUNS` parses of every source in `sources`, with the node
+/// count of the last.
+fn time_parses(parser: &mut Parser, sources: &[&str]) -> (Duration, usize) {
+    let mut best = Duration::MAX;
+    let mut nodes = 0;
+    for _ in 0..RUNS {
+        let mut elapsed = Duration::ZERO;
+        nodes = 0;
+        for source in sources {
+            let start = Instant::now();
+            let tree = parser.parse(source, None).unwrap();
+            elapsed += start.elapsed();
+            nodes += count_nodes(&tree);
+        }
+        best = best.min(elapsed);
+    }
+    (best, nodes)
+}
+
+fn run(parser: &mut Parser, job: &Job) -> Report {
+    match job {
+        Job::Corpus { grammar, path, language } => {
+            parser.set_language(&(*language).into()).expect("Error loading JASS grammar");
+            let name = format!("{}/{}", grammar, path.file_name().unwrap().to_string_lossy());
+            let text = std::fs::read_to_string(path).unwrap_or_default();
+            let entries = parse_corpus(&text);
+
+            let mut failures = Vec::new();
+            for entry in entries.iter().filter(|entry| !entry.skip) {
+                let tree = parser.parse(&entry.input, None).unwrap();
+                let root = tree.root_node();
+                if entry.error {
+                    if !root.has_error() {
+                        failures.push(format!("{}: {}: expected an error", name, entry.name));
+                    }
+                    continue;
+                }
+                let actual = normalize(&root.to_sexp());
+                if actual != entry.expected {
+                    failures.push(format!(
+                        "{}: {}\n  expected: {}\n  actual:   {}",
+                        name, entry.name, entry.expected, actual
+                    ));
+                }
+            }
+
+            let sources: Vec<&str> = entries.iter().map(|entry| entry.input.as_str()).collect();
+            let (time, nodes) = time_parses(parser, &sources);
+            Report {
+                name,
+                bytes: sources.iter().map(|source| source.len()).sum(),
+                nodes,
+                time,
+                failures,
+            }
+        }
+        Job::Source { name, source } => {
+            parser
+                .set_language(&tree_sitter_jass::language().into())
+                .expect("Error loading JASS grammar");
+            let (time, nodes) = time_parses(parser, &[source.as_str()]);
+            Report {
+                name: name.clone(),
+                bytes: source.len(),
+                nodes,
+                time,
+                failures: Vec::new(),
+            }
+        }
+    }
+}
+
+/// Runs every job on `threads` threads; reports come back in job order.
+fn run_all(jobs: &[Job], threads: usize) -> Vec<Report> {
+    let next = AtomicUsize::new(0);
+    let reports: Mutex<Vec<(usize, Report)>> = Mutex::new(Vec::with_capacity(jobs.len()));
+    std::thread::scope(|scope| {
+        for _ in 0..threads.min(jobs.len()).max(1) {
+            scope.spawn(|| {
+                let mut parser = Parser::new();
+                loop {
+                    let index = next.fetch_add(1, Ordering::Relaxed);
+                    let Some(job) = jobs.get(index) else { break };
+                    let report = run(&mut parser, job);
+                    reports.lock().unwrap().push((index, report));
+                }
+            });
+        }
+    });
+    let mut reports = reports.into_inner().unwrap();
+    reports.sort_by_key(|&(index, _)| index);
+    reports.into_iter().map(|(_, report)| report).collect()
+}
+
+/// `name<TAB>bytes<TAB>microseconds` lines.
+fn read_baseline(path: &Path) -> HashMap<String, Duration> {
+    let Ok(text) = std::fs::read_to_string(path) else {
+        return HashMap::new();
+    };
+    text.lines()
+        .filter_map(|line| {
+            let mut fields = line.split('\t');
+            let name = fields.next()?;
+            let micros = fields.nth(1)?.parse().ok()?;
+            Some((name.to_string(), Duration::from_micros(micros)))
+        })
+        .collect()
+}
+
+fn write_baseline(path: &Path, reports: &[Report]) -> std::io::Result<()> {
+    let mut text = String::new();
+    for report in reports {
+        text.push_str(&format!("{}\t{}\t{}\n", report.name, report.bytes, report.time.as_micros()));
+    }
+    if let Some(parent) = path.parent() {
+        std::fs::create_dir_all(parent)?;
+    }
+    std::fs::write(path, text)
+}
+
+fn env_or<T: std::str::FromStr>(name: &str, default: T) -> T {
+    std::env::var(name).ok().and_then(|value| value.parse().ok()).unwrap_or(default)
+}
+
+fn main() -> ExitCode {
+    // Anything that is not a flag is a name filter
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let update = args.iter().any(|arg| arg == "--update-baseline");
+    let filter: Vec<&String> = args.iter().filter(|arg| !arg.starts_with("--")).collect();
+    let matches = |name: &str| filter.is_empty() || filter.iter().any(|f| name.contains(f.as_str()));
+
+    let root = Path::new(env!("CARGO_MANIFEST_DIR"));
+    let mut jobs = Vec::new();
+    for (grammar, dir, language) in corpora() {
+        let mut paths: Vec<PathBuf> = std::fs::read_dir(root.join(dir))
+            .into_iter()
+            .flatten()
+            .flatten()
+            .map(|entry| entry.path())
+            .filter(|path| path.extension().is_some_and(|extension| extension == "txt"))
+            .collect();
+        paths.sort();
+        for path in paths {
+            let name = format!("{}/{}", grammar, path.file_name().unwrap().to_string_lossy());
+            if matches(&name) {
+                jobs.push(Job::Corpus { grammar, path, language });
+            }
+        }
+    }
+    for input in corpus::load() {
+        if matches(&input.name) {
+            jobs.push(Job::Source {
+                name: input.name,
+                source: input.source,
+            });
+        }
+    }
+
+    let threads = env_or(
+        "JASS_CORPUS_THREADS",
+        std::thread::available_parallelism().map_or(1, |n| n.get()),
+    );
+    let threshold: f64 = env_or("JASS_CORPUS_THRESHOLD", 2.0);
+    let baseline_path = std::env::var_os("JASS_CORPUS_BASELINE").map(PathBuf::from);
+    let baseline = match &baseline_path {
+        Some(path) if !update => read_baseline(path),
+        _ => HashMap::new(),
+    };
+
+    let start = Instant::now();
+    let reports = run_all(&jobs, threads);
+
+    println!(
+        "{:<40} {:>10} {:>10} {:>10} {:>10} {:>7}",
+        "input", "bytes", "nodes", "ms", "baseline", "ratio"
+    );
+    let mut regressions = Vec::new();
+    for report in &reports {
+        let ms = report.time.as_secs_f64() * 1e3;
+        let (previous, ratio) = match baseline.get(&report.name) {
+            Some(previous) => (
+                format!("{:.3}", previous.as_secs_f64() * 1e3),
+                format!("{:.2}", report.time.as_secs_f64() / previous.as_secs_f64().max(1e-9)),
+            ),
+            None => ("-".to_string(), "-".to_string()),
+        };
+        println!(
+            "{:<40} {:>10} {:>10} {:>10.3} {:>10} {:>7}",
+            report.name, report.bytes, report.nodes, ms, previous, ratio
+        );
+        if let Some(&previous) = baseline.get(&report.name) {
+            if report.time.as_secs_f64() > previous.as_secs_f64() * threshold
+                && report.time.saturating_sub(previous) >= MIN_REGRESSION
+            {
+                regressions.push(format!(
+                    "{}: {:.3} ms, baseline {:.3} ms",
+                    report.name,
+                    ms,
+                    previous.as_secs_f64() * 1e3
+                ));
+            }
+        }
+    }
+    println!(
+        "\n{} inputs on {} threads in {:.2}s",
+        reports.len(),
+        threads,
+        start.elapsed().as_secs_f64()
+    );
+
+    if update {
+        let Some(path) = &baseline_path else {
+            eprintln!("--update-baseline needs JASS_CORPUS_BASELINE");
+            return ExitCode::FAILURE;
+        };
+        if let Err(error) = write_baseline(path, &reports) {
+            eprintln!("{}: {}", path.display(), error);
+            return ExitCode::FAILURE;
+        }
+        println!("wrote {}", path.display());
+    }
+
+    let failures: Vec<&String> = reports.iter().flat_map(|report| &report.failures).collect();
+    for failure in &failures {
+        eprintln!("FAIL {}", failure);
+    }
+    for regression in &regressions {
+        eprintln!("SLOWER {} (threshold {}x)", regression, threshold);
+    }
+    if failures.is_empty() && regressions.is_empty() {
+        ExitCode::SUCCESS
+    } else {
+        eprintln!("{} corpus failures, {} timing regressions", failures.len(), regressions.len());
+        ExitCode::FAILURE
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * JASS grammar variant with flat operator chains
+ *
+ * Identical to ../grammar.js except for expressions: a run of binary
+ * operators of one precedence level becomes a single `binary_chain` node
+ * whose children alternate operands and operators, and the other operators
+ * are named nodes (assign_expr, unary_expr, postfix_expr, subscript_expr).
+ *
+ *   a + b - c + d   ->  (binary_chain operand: (id) operand: (id) operand: (id) operand: (id))
+ *   a and b or c    ->  (binary_chain operand: (id) operand: (binary_chain operand: (id) operand: (id)))
+ *
+ * The default grammar nests these as left-deep trees of expr nodes, so depth
+ * grows with the length of the chain. Here depth is bounded by the number
+ * of precedence levels, and every extra operand costs no node of its own.
+ *
+ * STRATIFIED EXPRESSIONS:
+ * Instead of resolving operators with prec() over one recursive `expr`,
+ * every precedence level is its own hidden rule whose operands come from
+ * the next (tighter) level. A chain is `operand (op operand)+` at one
+ * level, so there is nothing left for a GLR conflict to decide.
+ *
+ *   expr -> assign_expr | and -> or -> equality -> relational
+ *        -> additive -> multiplicative -> unary -> postfix -> primary
+ */
+
+const JASS = require('../grammar')
+
+// Same values as PREC in ../grammar.js. They only settle shift/reduce
+// choices against statement boundaries (`a` then `-b` as two statements);
+// the nesting itself comes from the level structure.
+const PREC = {
+    ASSIGNMENT: 1,
+    POSTFIX: 19,
+    CALL: 20,
+}
+
+// Binary operator levels, loosest first. Note: 'or' binds tighter than 'and'.
+const LEVELS = [
+    [12, ['and']],
+    [13, ['or']],
+    [14, ['==', '!=']],
+    [15, ['<', '>', '<=', '>=']],
+    [16, ['+', '-']],
+    [17, ['*', '/']],
+]
+
+const level = i => `_level_${i}`
+const chain = i => `_chain_${i}`
+
+const levelRules = {}
+LEVELS.forEach(([precedence, operators], i) => {
+    levelRules[level(i)] = $ => choice(alias($[chain(i)], $.binary_chain), $[level(i + 1)])
+    levelRules[chain(i)] = $ => prec.left(precedence, seq(
+        field('operand', $[level(i + 1)]),
+        repeat1(seq(
+            field('operator', choice(...operators)),
+            field('operand', $[level(i + 1)])
+        ))
+    ))
+})
+
+module.exports = grammar(JASS, {
+    name: 'jass_chain',
+
+    // ../grammar.js declares [var_stmt, expr], but here `expr` is only a
+    // choice between levels: after a leading identifier the statement-level
+    // conflict is between var_stmt and the `_primary` that would reduce it
+    conflicts: $ => [
+        [$.var_stmt, $._primary],
+    ],
+
+    // The levels are hidden, so operands sit directly in the chain; expr
+    // itself is a supertype and doesn't wrap them either
+    supertypes: $ => [$.expr],
+
+    rules: {
+        expr: $ => choice(
+            $.assign_expr,
+            $[level(0)],
+        ),
+
+        assign_expr: $ => prec.right(PREC.ASSIGNMENT, seq(
+            field('left', $[level(0)]),
+            '=',
+            field('right', $.expr)
+        )),
+
+        ...levelRules,
+
+        // Unary level: prefix operators bind tighter than any binary operator
+        [level(LEVELS.length)]: $ => choice(
+            $.unary_expr,
+            $._postfix
+        ),
+
+        unary_expr: $ => seq(
+            field('operator', choice('++', '--', 'not', '-', '+')),
+            field('operand', $[level(LEVELS.length)])
+        ),
+
+        _postfix: $ => choice(
+            $.postfix_expr,
+            $.subscript_expr,
+            $.function_call,
+            $._primary
+        ),
+
+        postfix_expr: $ => prec.left(PREC.POSTFIX, seq(
+            field('operand', $._postfix),
+            field('operator', choice('++', '--'))
+        )),
+
+        subscript_expr: $ => prec.left(PREC.CALL, seq(
+            field('array', $._postfix),
+            '[',
+            field('index', $.expr),
+            ']'
+        )),
+
+        function_call: $ => prec.left(PREC.CALL, seq(
+            field('name', $._postfix),
+            '(',
+            field('args', optional($.function_arguments)),
+            ')'
+        )),
+
+        _primary: $ => choice(
+            $.number,
+            $.rawcode,
+            $.float,
+            $.string,
+            $.id,
+            $.function_ref,
+            $.parens
+        ),
+    }
+});
@@ -0,0 +1,115 @@
+// Generated by script/generate-keywords.js from src/grammar.json.
+// Do not edit: run `node script/generate-keywords.js` after `tree-sitter generate`.
+
+#ifndef TREE_SITTER_JASS_KEYWORDS_H_
+#define TREE_SITTER_JASS_KEYWORDS_H_
+
+#include <stddef.h>
+#include <string.h>
+
+typedef enum {
+    KW_NONE,
+    KW_AND,
+    KW_ARRAY,
+    KW_CALL,
+    KW_CONSTANT,
+    KW_ELSE,
+    KW_ELSEIF,
+    KW_ENDFUNCTION,
+    KW_ENDGLOBALS,
+    KW_ENDIF,
+    KW_ENDLOOP,
+    KW_EXITWHEN,
+    KW_EXTENDS,
+    KW_FUNCTION,
+    KW_GLOBALS,
+    KW_IF,
+    KW_LOCAL,
+    KW_LOOP,
+    KW_NATIVE,
+    KW_NOT,
+    KW_NOTHING,
+    KW_OR,
+    KW_RETURN,
+    KW_RETURNS,
+    KW_SET,
+    KW_TAKES,
+    KW_THEN,
+    KW_TYPE,
+} Keyword;
+
+#define KEYWORD_COUNT 27
+#define KEYWORD_MAX_LEN 11
+
+// Returns the keyword spelled by word[0..len), or KW_NONE for identifiers.
+static inline Keyword keyword_lookup(const char *word, size_t len) {
+    switch (len) {
+        case 2:
+            switch (word[0]) {
+                case 'i': return memcmp(word, "if", 2) == 0 ? KW_IF : KW_NONE;
+                case 'o': return memcmp(word, "or", 2) == 0 ? KW_OR : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 3:
+            switch (word[0]) {
+                case 'a': return memcmp(word, "and", 3) == 0 ? KW_AND : KW_NONE;
+                case 'n': return memcmp(word, "not", 3) == 0 ? KW_NOT : KW_NONE;
+                case 's': return memcmp(word, "set", 3) == 0 ? KW_SET : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 4:
+            switch (word[1]) {
+                case 'a': return memcmp(word, "call", 4) == 0 ? KW_CALL : KW_NONE;
+                case 'l': return memcmp(word, "else", 4) == 0 ? KW_ELSE : KW_NONE;
+                case 'o': return memcmp(word, "loop", 4) == 0 ? KW_LOOP : KW_NONE;
+                case 'h': return memcmp(word, "then", 4) == 0 ? KW_THEN : KW_NONE;
+                case 'y': return memcmp(word, "type", 4) == 0 ? KW_TYPE : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 5:
+            switch (word[0]) {
+                case 'a': return memcmp(word, "array", 5) == 0 ? KW_ARRAY : KW_NONE;
+                case 'e': return memcmp(word, "endif", 5) == 0 ? KW_ENDIF : KW_NONE;
+                case 'l': return memcmp(word, "local", 5) == 0 ? KW_LOCAL : KW_NONE;
+                case 't': return memcmp(word, "takes", 5) == 0 ? KW_TAKES : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 6:
+            switch (word[0]) {
+                case 'e': return memcmp(word, "elseif", 6) == 0 ? KW_ELSEIF : KW_NONE;
+                case 'n': return memcmp(word, "native", 6) == 0 ? KW_NATIVE : KW_NONE;
+                case 'r': return memcmp(word, "return", 6) == 0 ? KW_RETURN : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 7:
+            switch (word[1]) {
+                case 'n': return memcmp(word, "endloop", 7) == 0 ? KW_ENDLOOP : KW_NONE;
+                case 'x': return memcmp(word, "extends", 7) == 0 ? KW_EXTENDS : KW_NONE;
+                case 'l': return memcmp(word, "globals", 7) == 0 ? KW_GLOBALS : KW_NONE;
+                case 'o': return memcmp(word, "nothing", 7) == 0 ? KW_NOTHING : KW_NONE;
+                case 'e': return memcmp(word, "returns", 7) == 0 ? KW_RETURNS : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 8:
+            switch (word[0]) {
+                case 'c': return memcmp(word, "constant", 8) == 0 ? KW_CONSTANT : KW_NONE;
+                case 'e': return memcmp(word, "exitwhen", 8) == 0 ? KW_EXITWHEN : KW_NONE;
+                case 'f': return memcmp(word, "function", 8) == 0 ? KW_FUNCTION : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 10:
+            switch (word[0]) {
+                case 'e': return memcmp(word, "endglobals", 10) == 0 ? KW_ENDGLOBALS : KW_NONE;
+                default: return KW_NONE;
+            }
+        case 11:
+            switch (word[0]) {
+                case 'e': return memcmp(word, "endfunction", 11) == 0 ? KW_ENDFUNCTION : KW_NONE;
+                default: return KW_NONE;
+            }
+        default:
+            return KW_NONE;
+    }
+}
+
+#endif  // TREE_SITTER_JASS_KEYWORDS_H_
@@ -0,0 +1,511 @@
+// External scanner shared by every JASS grammar in this repository.
+//
+// Each grammar's src/scanner.c includes this file and defines the
+// tree_sitter_<name>_external_scanner_* entry points around jass_scan().
+// Variants with extra external tokens define JASS_<VARIANT> first;
+// nocomments/src/scanner.c defines JASS_SKIP_COMMENTS.
+
+#ifndef TREE_SITTER_JASS_SCANNER_H_
+#define TREE_SITTER_JASS_SCANNER_H_
+
+#include "tree_sitter/parser.h"
+#include "keywords.h"
+#include "scanner_stats.h"
+
+// External token types — must match grammar.js externals order exactly
+enum TokenType {
+    COMMENT,
+    STRING_CONTENT,
+    ESCAPE_SEQUENCE,
+    RAWCODE,
+    ID_TOKEN,
+    VIRTUAL_ENDLOOP,
+    VIRTUAL_ENDGLOBALS,
+    VIRTUAL_ENDFUNCTION,
+    VIRTUAL_ENDIF,
+#ifdef JASS_DECLS
+    FUNCTION_BODY,      // decls/grammar.js only
+#endif
+    TOKEN_TYPE_COUNT,
+};
+
+// --- Instrumentation ---
+//
+// JASS_COUNT(counter) bumps a JassScannerStats field of this thread when
+// built with JASS_SCANNER_STATS, and is nothing otherwise.
+
+#ifdef JASS_SCANNER_STATS
+#if defined(_MSC_VER)
+static __declspec(thread) JassScannerStats jass_stats;
+#else
+static _Thread_local JassScannerStats jass_stats;
+#endif
+#define JASS_COUNT(counter) ((void)jass_stats.counter++)
+#else
+#define JASS_COUNT(counter) ((void)0)
+#endif
+
+// Fails to compile if JassScannerStats.tokens lacks a slot per external token
+typedef char jass_token_slots_check[TOKEN_TYPE_COUNT <= JASS_SCANNER_TOKEN_SLOTS ? 1 : -1];
+
+// Body of each grammar's tree_sitter_<name>_scanner_stats()
+static bool jass_read_stats(JassScannerStats *out, bool reset) {
+#ifdef JASS_SCANNER_STATS
+    *out = jass_stats;
+    if (reset) jass_stats = (JassScannerStats){0};
+    return true;
+#else
+    (void)reset;
+    *out = (JassScannerStats){0};
+    return false;
+#endif
+}
+
+// --- Keywords ---
+//
+// keyword_lookup() comes from common/keywords.h, generated from the grammar's
+// keyword list by script/generate-keywords.js.
+
+// --- Literal limits ---
+//
+// Unterminated literals must not make a single scan run to EOF: error
+// recovery lexes from many positions, which would turn one stray quote into
+// quadratic work. Both limits can be overridden at compile time.
+
+// Rawcodes are 1 or 4 characters ('A', 'hfoo'); allow a little slack for
+// malformed maps, then give up on the quote.
+#ifndef JASS_RAWCODE_MAX_LEN
+#define JASS_RAWCODE_MAX_LEN 8
+#endif
+
+// String content is emitted in chunks ending after a newline or after this
+// many characters. The content token is hidden, so the tree is unchanged.
+#ifndef JASS_STRING_CHUNK_MAX
+#define JASS_STRING_CHUNK_MAX 1024
+#endif
+
+// --- Character helpers ---
+
+static bool is_id_start(int32_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool is_id_cont(int32_t c) {
+    return is_id_start(c) || (c >= '0' && c <= '9');
+}
+
+static void advance(TSLexer *lexer) {
+    JASS_COUNT(advanced);
+    lexer->advance(lexer, false);
+}
+
+static void skip_ws(TSLexer *lexer) {
+    JASS_COUNT(skipped);
+    lexer->advance(lexer, true);
+}
+
+// --- Word classification ---
+//
+// An identifier-start word is read exactly once and classified. The result
+// decides both whether a virtual close is emitted and whether the word is
+// an ID_TOKEN, so block bodies cost a single pass per word.
+
+// Longer than any keyword; words that don't fit are always identifiers
+#define WORD_BUF_SIZE (KEYWORD_MAX_LEN + 1)
+
+// Consume [a-zA-Z0-9_]* and return its keyword, or KW_NONE for identifiers
+static Keyword read_word(TSLexer *lexer) {
+    char buf[WORD_BUF_SIZE];
+    size_t len = 0;
+    while (is_id_cont(lexer->lookahead)) {
+        if (len < WORD_BUF_SIZE) buf[len] = (char)lexer->lookahead;
+        len++;
+        advance(lexer);
+    }
+    Keyword kw = len < WORD_BUF_SIZE ? keyword_lookup(buf, len) : KW_NONE;
+    if (kw == KW_NONE) JASS_COUNT(keyword_misses);
+    return kw;
+}
+
+static bool is_close_keyword(Keyword kw) {
+    return kw == KW_ENDLOOP || kw == KW_ENDGLOBALS ||
+           kw == KW_ENDFUNCTION || kw == KW_ENDIF;
+}
+
+static void skip_blank(TSLexer *lexer) {
+    while (lexer->lookahead == ' ' || lexer->lookahead == '\t' ||
+           lexer->lookahead == '\r' || lexer->lookahead == '\n') {
+        advance(lexer);
+    }
+}
+
+// Skip whitespace, then read_word(); KW_NONE if no word follows
+static Keyword read_next_word(TSLexer *lexer) {
+    skip_blank(lexer);
+    return is_id_start(lexer->lookahead) ? read_word(lexer) : KW_NONE;
+}
+
+// --- Top-level declarations ---
+//
+// `globals`, `native`, `type` and `function ... takes` at the start of a
+// line (column 0) only occur at the top level of a real map. Meeting one
+// while a block is open means that block lost its closer, so the scanner
+// closes it there instead of letting the rest of the file nest inside it.
+// Indented declarations still nest. `function F` alone is a function_ref
+// (`return function F`), and `constant` is a declaration start only before
+// `native`: function_statement has no `constant`. Reads ahead of the token
+// end; *last is set to the last keyword read.
+static bool is_declaration_start(TSLexer *lexer, Keyword kw, Keyword *last) {
+    *last = kw;
+    if (kw == KW_CONSTANT) {
+        kw = *last = read_next_word(lexer);
+        if (kw != KW_NATIVE) return false;
+    }
+    switch (kw) {
+        case KW_GLOBALS:
+        case KW_NATIVE:
+        case KW_TYPE:
+            return true;
+        case KW_FUNCTION:
+            // The name, then `takes`
+            if (read_next_word(lexer) != KW_NONE) return false;
+            *last = read_next_word(lexer);
+            return *last == KW_TAKES;
+        default:
+            return false;
+    }
+}
+
+#ifdef JASS_DECLS
+// --- Opaque function body (decls variant) ---
+//
+// Everything between a function signature and its `endfunction` becomes one
+// function_body token, ending at the last character before that keyword.
+// Strings, rawcodes and comments are skipped as units so the word
+// `endfunction` inside them doesn't end the body. When the body is
+// empty the scanner yields and `endfunction` is lexed as usual.
+//
+// A declaration at the start of a line also ends the body, so a function
+// missing its `endfunction` swallows only itself. If the body is empty
+// there, the function is closed right away with a virtual endfunction.
+// line_start tells whether the body starts in column 0.
+static bool scan_function_body(TSLexer *lexer, bool can_close, bool line_start) {
+    bool empty = true;
+    lexer->mark_end(lexer);
+    for (;;) {
+        int32_t c = lexer->lookahead;
+        if (c == 0) break;
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            line_start = c == '\n';
+            advance(lexer);
+            continue;
+        }
+        if (is_id_cont(c)) {
+            Keyword kw = read_word(lexer);
+            if (kw == KW_ENDFUNCTION) break;
+            Keyword last = kw;
+            if (line_start && is_declaration_start(lexer, kw, &last)) {
+                if (empty && can_close) {
+                    lexer->result_symbol = VIRTUAL_ENDFUNCTION;
+                    return true;
+                }
+                break;
+            }
+            // `function F` followed by `endfunction`: the lookahead went past
+            // the end of the body
+            if (last == KW_ENDFUNCTION) break;
+        } else if (c == '"') {
+            advance(lexer);
+            while (lexer->lookahead != '"' && lexer->lookahead != 0) {
+                if (lexer->lookahead == '\\') advance(lexer);
+                if (lexer->lookahead != 0) advance(lexer);
+            }
+            if (lexer->lookahead == '"') advance(lexer);
+        } else if (c == '\'') {
+            advance(lexer);
+            for (unsigned len = 0; len <= JASS_RAWCODE_MAX_LEN; len++) {
+                if (lexer->lookahead == 0) break;
+                bool close = lexer->lookahead == '\'';
+                advance(lexer);
+                if (close) break;
+            }
+        } else if (c == '/') {
+            advance(lexer);
+            if (lexer->lookahead == '/') {
+                while (lexer->lookahead != '\n' && lexer->lookahead != '\r' && lexer->lookahead != 0) {
+                    advance(lexer);
+                }
+            }
+        } else {
+            advance(lexer);
+        }
+        // Trailing whitespace stays outside the token
+        lexer->mark_end(lexer);
+        empty = false;
+        line_start = false;
+    }
+    lexer->result_symbol = FUNCTION_BODY;
+    return !empty;
+}
+#endif
+
+// --- Main scan ---
+
+static bool scan_token(TSLexer *lexer, const bool *valid_symbols) {
+
+    // During error recovery, tree-sitter sets ALL valid_symbols to true.
+    // We must not blindly match STRING_CONTENT or virtual tokens in that state.
+    bool error_recovery =
+        valid_symbols[COMMENT] &&
+        valid_symbols[STRING_CONTENT] &&
+        valid_symbols[ESCAPE_SEQUENCE] &&
+        valid_symbols[RAWCODE] &&
+        valid_symbols[ID_TOKEN] &&
+        valid_symbols[VIRTUAL_ENDLOOP] &&
+        valid_symbols[VIRTUAL_ENDGLOBALS] &&
+        valid_symbols[VIRTUAL_ENDFUNCTION] &&
+        valid_symbols[VIRTUAL_ENDIF];
+    if (error_recovery) JASS_COUNT(error_recovery);
+
+    // Escape sequence inside double-quoted string: \\, \", \n, \r
+    if (valid_symbols[ESCAPE_SEQUENCE] && !error_recovery && lexer->lookahead == '\\') {
+        advance(lexer);
+        if (lexer->lookahead == '\\' || lexer->lookahead == '"' || lexer->lookahead == 'n' || lexer->lookahead == 'r') {
+            advance(lexer);
+            lexer->mark_end(lexer);
+            lexer->result_symbol = ESCAPE_SEQUENCE;
+            return true;
+        }
+        // Not a valid escape — treat backslash as string content
+        // Fall through; mark_end was not called so nothing consumed
+        return false;
+    }
+
+    // String content — everything except closing quote, backslash, and EOF.
+    // A chunk ends after a newline or JASS_STRING_CHUNK_MAX characters.
+    if (valid_symbols[STRING_CONTENT] && !error_recovery) {
+        lexer->result_symbol = STRING_CONTENT;
+        unsigned len = 0;
+        while (len < JASS_STRING_CHUNK_MAX) {
+            if (lexer->lookahead == '"' || lexer->lookahead == '\\' || lexer->lookahead == 0) {
+                break;
+            }
+            bool newline = lexer->lookahead == '\n';
+            advance(lexer);
+            len++;
+            if (newline) break;
+        }
+        return len > 0;
+    }
+
+    // Skip whitespace, noting whether the token starts a line
+    bool skipped = false;
+    bool line_start = false;
+    while (lexer->lookahead == ' ' || lexer->lookahead == '\t' ||
+           lexer->lookahead == '\r' || lexer->lookahead == '\n') {
+        skipped = true;
+        line_start = lexer->lookahead == '\n';
+        skip_ws(lexer);
+    }
+
+#ifdef JASS_SKIP_COMMENTS
+    // Comments are whitespace too (nocomments/grammar.js), so the virtual
+    // closes below see the word after them. The internal lexer skips them
+    // as a separator whenever this scan yields.
+    while (lexer->lookahead == '/') {
+        skip_ws(lexer);
+        // A lone `/` is the division operator, lexed internally
+        if (lexer->lookahead != '/') return false;
+        while (lexer->lookahead != '\n' && lexer->lookahead != '\r' && lexer->lookahead != 0) {
+            skip_ws(lexer);
+        }
+        line_start = false;
+        while (lexer->lookahead == ' ' || lexer->lookahead == '\t' ||
+               lexer->lookahead == '\r' || lexer->lookahead == '\n') {
+            line_start = lexer->lookahead == '\n';
+            skip_ws(lexer);
+        }
+    }
+#endif
+
+#ifdef JASS_DECLS
+    if (valid_symbols[FUNCTION_BODY] && !error_recovery) {
+        // Nothing consumed at EOF: fall through to the virtual closes
+        if (lexer->lookahead != 0) {
+            if (!skipped) line_start = lexer->get_column(lexer) == 0;
+            return scan_function_body(lexer, valid_symbols[VIRTUAL_ENDFUNCTION], line_start);
+        }
+    }
+#endif
+
+    // Rawcode (FourCC) literal: 'xxxx' — no escapes, newlines allowed,
+    // at most JASS_RAWCODE_MAX_LEN characters
+    if (valid_symbols[RAWCODE] && !error_recovery && lexer->lookahead == '\'') {
+        advance(lexer);
+        unsigned len = 0;
+        while (lexer->lookahead != '\'' && lexer->lookahead != 0) {
+            if (++len > JASS_RAWCODE_MAX_LEN) return false;
+            advance(lexer);
+        }
+        if (lexer->lookahead == '\'') {
+            advance(lexer);
+            lexer->mark_end(lexer);
+            lexer->result_symbol = RAWCODE;
+            return true;
+        }
+        return false;
+    }
+
+
+    // --- Identifiers and virtual closing tokens ---
+    //
+    // Logic: when the grammar expects a virtual close (meaning we're at the
+    // end-position of some inner block), look at the upcoming word. If it's
+    // a closing keyword but NOT the one for this block, emit the virtual close
+    // so tree-sitter can properly terminate the inner block.
+    //
+    // Example:  globals / a=2 / loop / endglobals
+    //   Inside loop_statement, grammar expects 'endloop' or _virtual_endloop.
+    //   Scanner reads "endglobals" → it's a closer but not "endloop"
+    //   → emit _virtual_endloop (zero-width) → loop closes
+    //   → next step, grammar sees "endglobals" and closes globals normally
+    //
+    // A top-level declaration at the start of a line (see
+    // is_declaration_start) closes the block the same way, so one missing
+    // closer costs one function, not the rest of the map:
+    //   function F ... / loop / function G takes ...
+    //   → _virtual_endloop, _virtual_endfunction, then function G
+    //
+    // Otherwise the same word becomes ID_TOKEN: [a-zA-Z_][a-zA-Z0-9_]* that
+    // is NOT a keyword. Keywords are rejected, forcing tree-sitter to match
+    // them as keyword tokens.
+    //
+    // We also emit virtual close if we see EOF (below), which means the
+    // block was never closed.
+    if (is_id_start(lexer->lookahead)) {
+        // Which virtual tokens does the grammar currently accept?
+        bool want_endloop = valid_symbols[VIRTUAL_ENDLOOP] && !error_recovery;
+        bool want_endglobals = valid_symbols[VIRTUAL_ENDGLOBALS] && !error_recovery;
+        bool want_endfunction = valid_symbols[VIRTUAL_ENDFUNCTION] && !error_recovery;
+        bool want_endif = valid_symbols[VIRTUAL_ENDIF] && !error_recovery;
+        bool want_close = want_endloop || want_endglobals || want_endfunction || want_endif;
+
+        if (!valid_symbols[ID_TOKEN]) {
+            if (!want_close) return false;
+            // Closers start with "end"; declarations with one of "cfgnt"
+            switch (lexer->lookahead) {
+                case 'e': case 'c': case 'f': case 'g': case 'n': case 't':
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        // Right after a zero-width virtual close nothing is skipped: ask for
+        // the column instead
+        if (want_close && !skipped) line_start = lexer->get_column(lexer) == 0;
+
+        // Virtual closes are zero-width: end them before the word
+        lexer->mark_end(lexer);
+
+        Keyword kw = read_word(lexer);
+
+        Keyword last;
+        if (want_close && line_start && !is_close_keyword(kw) &&
+            is_declaration_start(lexer, kw, &last)) {
+            if (want_endloop) {
+                lexer->result_symbol = VIRTUAL_ENDLOOP;
+                return true;
+            }
+            if (want_endif) {
+                lexer->result_symbol = VIRTUAL_ENDIF;
+                return true;
+            }
+            if (want_endfunction) {
+                lexer->result_symbol = VIRTUAL_ENDFUNCTION;
+                return true;
+            }
+            lexer->result_symbol = VIRTUAL_ENDGLOBALS;
+            return true;
+        }
+
+        // Emit virtual close if the closing keyword does NOT match our block
+        if (is_close_keyword(kw)) {
+            if (want_endloop && kw != KW_ENDLOOP) {
+                lexer->result_symbol = VIRTUAL_ENDLOOP;
+                return true;
+            }
+            if (want_endglobals && kw != KW_ENDGLOBALS) {
+                lexer->result_symbol = VIRTUAL_ENDGLOBALS;
+                return true;
+            }
+            if (want_endfunction && kw != KW_ENDFUNCTION) {
+                lexer->result_symbol = VIRTUAL_ENDFUNCTION;
+                return true;
+            }
+            if (want_endif && kw != KW_ENDIF) {
+                lexer->result_symbol = VIRTUAL_ENDIF;
+                return true;
+            }
+        }
+
+        // is_declaration_start() only reads past keywords, so an identifier
+        // still ends where read_word() stopped
+        if (valid_symbols[ID_TOKEN] && kw == KW_NONE) {
+            lexer->mark_end(lexer);
+            lexer->result_symbol = ID_TOKEN;
+            return true;
+        }
+        if (want_close) JASS_COUNT(word_peeks);
+        return false;
+    }
+
+    // Also emit virtual close at EOF (but not during error recovery)
+    if (lexer->lookahead == 0 && !error_recovery) {
+        if (valid_symbols[VIRTUAL_ENDLOOP]) {
+            lexer->mark_end(lexer);
+            lexer->result_symbol = VIRTUAL_ENDLOOP;
+            return true;
+        }
+        if (valid_symbols[VIRTUAL_ENDIF]) {
+            lexer->mark_end(lexer);
+            lexer->result_symbol = VIRTUAL_ENDIF;
+            return true;
+        }
+        if (valid_symbols[VIRTUAL_ENDFUNCTION]) {
+            lexer->mark_end(lexer);
+            lexer->result_symbol = VIRTUAL_ENDFUNCTION;
+            return true;
+        }
+        if (valid_symbols[VIRTUAL_ENDGLOBALS]) {
+            lexer->mark_end(lexer);
+            lexer->result_symbol = VIRTUAL_ENDGLOBALS;
+            return true;
+        }
+    }
+
+    // Single-line comment: // ...
+    if (valid_symbols[COMMENT] && lexer->lookahead == '/') {
+        advance(lexer);
+        if (lexer->lookahead == '/') {
+            advance(lexer);
+            while (lexer->lookahead != '\n' && lexer->lookahead != '\r' && lexer->lookahead != 0) {
+                advance(lexer);
+            }
+            lexer->result_symbol = COMMENT;
+            return true;
+        }
+        return false;
+    }
+
+    return false;
+}
+
+static bool jass_scan(TSLexer *lexer, const bool *valid_symbols) {
+    JASS_COUNT(invocations);
+    bool found = scan_token(lexer, valid_symbols);
+    if (found) JASS_COUNT(tokens[lexer->result_symbol]);
+    return found;
+}
+
+#endif  // TREE_SITTER_JASS_SCANNER_H_
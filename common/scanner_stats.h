@@ -0,0 +1,47 @@
+// Scanner instrumentation counters (JASS_SCANNER_STATS).
+//
+// When a grammar's scanner.c is compiled with -DJASS_SCANNER_STATS, the
+// external scanner counts its work in thread-local counters. Each grammar
+// exports one accessor that copies the calling thread's counters:
+//
+//   bool tree_sitter_jass_scanner_stats(JassScannerStats *out, bool reset);
+//
+// (likewise tree_sitter_jass_chain_scanner_stats, ...). It returns false and
+// zeroes `out` when the scanner was built without the flag; the counters
+// themselves then compile to nothing. This header has no tree-sitter
+// dependency so the bindings can include it.
+
+#ifndef TREE_SITTER_JASS_SCANNER_STATS_H_
+#define TREE_SITTER_JASS_SCANNER_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Slots of JassScannerStats.tokens, in the order of the grammar externals;
+// FUNCTION_BODY only occurs in jass_decls
+#define JASS_SCANNER_TOKEN_SLOTS 10
+
+typedef struct {
+    uint64_t invocations;     // calls of the external scanner
+    uint64_t error_recovery;  // ... of which with every external valid
+    uint64_t tokens[JASS_SCANNER_TOKEN_SLOTS];  // tokens emitted per TokenType
+    uint64_t advanced;        // characters advanced over, peeks included
+    uint64_t skipped;         // whitespace characters skipped
+    uint64_t word_peeks;      // words read for a virtual close that emitted none
+    uint64_t keyword_misses;  // words read that were identifiers, not keywords
+} JassScannerStats;
+
+bool tree_sitter_jass_scanner_stats(JassScannerStats *out, bool reset);
+bool tree_sitter_jass_chain_scanner_stats(JassScannerStats *out, bool reset);
+bool tree_sitter_jass_decls_scanner_stats(JassScannerStats *out, bool reset);
+bool tree_sitter_jass_nocomments_scanner_stats(JassScannerStats *out, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TREE_SITTER_JASS_SCANNER_STATS_H_
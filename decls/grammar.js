@@ -0,0 +1,40 @@
+/**
+ * JASS grammar variant for declarations only
+ *
+ * Identical to ../grammar.js except that a function body is not parsed: the
+ * external scanner lexes everything between the signature and `endfunction`
+ * as one opaque function_body token. Natives, types, globals and function
+ * signatures keep their full structure, which is all an index of the API
+ * surface (common.j, Blizzard.j, map headers) needs.
+ *
+ *   function F takes integer a returns nothing
+ *       call G(a)
+ *   endfunction
+ *
+ *   -> (function_statement name: (id) parameters: (parameter_list ...) (function_body))
+ */
+
+const JASS = require('../grammar')
+
+module.exports = grammar(JASS, {
+    name: 'jass_decls',
+
+    // Appended last: the scanner's TokenType enum has FUNCTION_BODY last
+    externals: ($, previous) => [
+        ...previous,
+        $.function_body,
+    ],
+
+    rules: {
+        function_statement: $ => seq(
+            'function',
+            field('name', $.id),
+            'takes',
+            field('parameters', choice('nothing', $.parameter_list)),
+            'returns',
+            field('return_type', choice('nothing', $.id)),
+            optional($.function_body),
+            choice('endfunction', $._virtual_endfunction)
+        ),
+    }
+});
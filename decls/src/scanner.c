@@ -0,0 +1,22 @@
+#define JASS_DECLS
+
+#include "tree_sitter/parser.h"
+#include "../../common/scanner.h"
+
+// --- Scanner lifecycle (no state needed) ---
+
+void *tree_sitter_jass_decls_external_scanner_create() { return NULL; }
+void tree_sitter_jass_decls_external_scanner_destroy(void *p) {}
+void tree_sitter_jass_decls_external_scanner_reset(void *p) {}
+unsigned tree_sitter_jass_decls_external_scanner_serialize(void *p, char *buf) { return 0; }
+void tree_sitter_jass_decls_external_scanner_deserialize(void *p, const char *b, unsigned n) {}
+
+bool tree_sitter_jass_decls_external_scanner_scan(void *payload, TSLexer *lexer,
+                                                  const bool *valid_symbols) {
+    return jass_scan(lexer, valid_symbols);
+}
+
+// Scanner counters of this thread; see common/scanner_stats.h
+bool tree_sitter_jass_decls_scanner_stats(JassScannerStats *out, bool reset) {
+    return jass_read_stats(out, reset);
+}
@@ -1,6 +1,6 @@
 #!/bin/bash
 set -e
 
-tree-sitter generate
-tree-sitter build --wasm
+node script/generate.js
+node script/build-wasm.js
 tree-sitter playground
@@ -29,6 +29,10 @@
  * ERROR RECOVERY:
  * When blocks are unclosed (e.g., 'function' without 'endfunction'),
  * tree-sitter automatically creates MISSING nodes that IDE can use for hints.
+ * The external scanner also closes open blocks with a virtual closer at the
+ * next declaration in column 0 (globals, native, constant native, type,
+ * function ... takes), so an unclosed block doesn't swallow the rest of
+ * the file.
  */
 
 // Operator precedence (higher = tighter binding)
@@ -106,6 +110,9 @@ module.exports = grammar({
             choice('endloop', $._virtual_endloop)
         ),
 
+        // `unit u` could also read as the statement `unit` followed by a
+        // statement starting with `u`. The parser forks at the conflict and
+        // dynamic precedence keeps the declaration.
         var_stmt: $ => prec.dynamic(1, seq(
             optional('constant'),
             field('type', $.id),
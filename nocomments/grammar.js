@@ -0,0 +1,33 @@
+/**
+ * JASS grammar variant without comment nodes
+ *
+ * Identical to ../grammar.js except that `// ...` comments are whitespace:
+ * the tree has no comment nodes, and parsing a comment costs no token, no
+ * node and no parser step. Meant for compilers, optimizers and minifiers
+ * that never look at comments; generated and decompiled maps can be half
+ * comments.
+ *
+ * The comment pattern becomes a separator of the internal lexer (an
+ * unnamed extra), and the external scanner skips comments in its
+ * whitespace loop (JASS_SKIP_COMMENTS in common/scanner.h), so virtual
+ * closes still see the keyword after a comment.
+ *
+ *   loop
+ *       call F() // tick
+ *   endloop      -> (loop_statement (call_statement (function_call name: (id))))
+ */
+
+const JASS = require('../grammar')
+
+module.exports = grammar(JASS, {
+    name: 'jass_nocomments',
+
+    // The first external keeps its slot, so the scanner's TokenType enum is
+    // unchanged, but is hidden and never emitted
+    externals: ($, previous) => [
+        $._comment,
+        ...previous.slice(1),
+    ],
+
+    extras: $ => [/\n/, /\s/, /\/\/[^\r\n]*/],
+});
@@ -0,0 +1,114 @@
+; Patterns match node kinds and fields only, so the query engine can rule
+; out a node by its kind without evaluating predicates. The one predicate,
+; on true/false/null, is a string set comparison, not a regex.
+; Earlier patterns win, so the catch-all `(id) @variable` comes last.
+
+(comment) @comment
+
+(string) @string
+(escape_sequence) @string.special
+
+(number) @number
+(float) @number
+(rawcode) @number
+
+; Declarations
+
+(function_statement
+  name: (id) @function)
+
+(native_statement
+  name: (id) @function)
+
+(type_statement
+  name: (id) @type
+  base: (id) @type)
+
+(function_statement
+  return_type: (id) @type)
+
+(native_statement
+  return_type: (id) @type)
+
+(parameter
+  type: (id) @type
+  name: (id) @variable.parameter)
+
+(local_statement
+  type: (id) @type)
+
+(var_stmt
+  type: (id) @type)
+
+"nothing" @type.builtin
+
+; Calls and references
+
+(function_call
+  name: (expr (id) @function))
+
+(function_ref
+  name: (id) @function)
+
+((id) @constant.builtin
+  (#any-of? @constant.builtin "true" "false" "null"))
+
+; Keywords
+
+[
+  "globals"
+  "endglobals"
+  "function"
+  "endfunction"
+  "native"
+  "takes"
+  "returns"
+  "type"
+  "extends"
+  "constant"
+  "array"
+  "local"
+  "set"
+  "call"
+  "return"
+  "if"
+  "then"
+  "elseif"
+  "else"
+  "endif"
+  "loop"
+  "endloop"
+  "exitwhen"
+  "and"
+  "or"
+  "not"
+] @keyword
+
+; Operators and punctuation
+
+[
+  "="
+  "=="
+  "!="
+  "<"
+  ">"
+  "<="
+  ">="
+  "+"
+  "-"
+  "*"
+  "/"
+  "++"
+  "--"
+] @operator
+
+[
+  "("
+  ")"
+  "["
+  "]"
+] @punctuation.bracket
+
+"," @punctuation.delimiter
+
+(id) @variable
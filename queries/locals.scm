@@ -0,0 +1,12 @@
+; Functions are the only scopes: parameters and locals are defined in
+; them, globals and every other name resolve at the top level.
+
+(function_statement) @local.scope
+
+(parameter
+  name: (id) @local.definition)
+
+(local_statement
+  name: (id) @local.definition)
+
+(id) @local.reference
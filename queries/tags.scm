@@ -0,0 +1,22 @@
+; Definitions are anchored on declaration kinds and their `name` field, so
+; a tags run touches top-level nodes, globals and calls only.
+
+(function_statement
+  name: (id) @name) @definition.function
+
+(native_statement
+  name: (id) @name) @definition.function
+
+(type_statement
+  name: (id) @name) @definition.type
+
+(globals
+  (var_stmt
+    (var_decl
+      name: (id) @name) @definition.variable))
+
+(function_call
+  name: (expr (id) @name)) @reference.call
+
+(function_ref
+  name: (id) @name) @reference.call
@@ -0,0 +1,116 @@
+#!/usr/bin/env node
+/**
+ * Native vs WASM parse benchmark.
+ *
+ *   node script/build-wasm.js && node script/bench-wasm.js
+ *   node script/bench-wasm.js path/to/tree-sitter-jass.wasm
+ *   JASS_BENCH_CORPUS=path/to/maps node script/bench-wasm.js
+ *
+ * Parses the same inputs as the Rust benchmarks' file corpus (the examples
+ * and every `.j`/`.jass` file under $JASS_BENCH_CORPUS) with the native
+ * addon through node-tree-sitter and with the WASM module through
+ * web-tree-sitter (Node's V8 stands in for the browser), and prints MB/s
+ * of both and their ratio. Before that it reports the module's startup
+ * cost: its size, WebAssembly.compile, Language.load (compile, instantiate
+ * and dynamic linking) and the first, cold parse.
+ *
+ * Needs the `tree-sitter` and `web-tree-sitter` packages and a built
+ * module (tree-sitter-jass.wasm by default).
+ */
+
+const fs = require('fs')
+const path = require('path')
+
+const root = path.join(__dirname, '..')
+const wasmPath = path.resolve(process.argv.slice(2).find(arg => arg.endsWith('.wasm')) || path.join(root, 'tree-sitter-jass.wasm'))
+const filter = process.argv.slice(2).filter(arg => !arg.endsWith('.wasm') && !arg.startsWith('--'))
+
+// Same limits as bindings/rust/benches/parse.rs
+const MIN_TIME = 0.5
+const MAX_ITERATIONS = 10000
+
+function inputs() {
+    const files = ['examples/example.jass', 'examples/test.jass'].map(file => path.join(root, file))
+    const walk = dir => {
+        for (const entry of fs.readdirSync(dir, { withFileTypes: true })) {
+            const file = path.join(dir, entry.name)
+            if (entry.isDirectory()) walk(file)
+            else if (/\.(j|jass)$/.test(entry.name)) files.push(file)
+        }
+    }
+    if (process.env.JASS_BENCH_CORPUS) walk(process.env.JASS_BENCH_CORPUS)
+    return files
+        .filter(file => fs.existsSync(file))
+        .map(file => ({ name: path.relative(root, file), source: fs.readFileSync(file, 'utf8') }))
+        .filter(input => filter.length === 0 || filter.some(f => input.name.includes(f)))
+        .sort((a, b) => a.source.length - b.source.length)
+}
+
+function seconds(start) {
+    return Number(process.hrtime.bigint() - start) / 1e9
+}
+
+// Mean seconds per call of `parse`, run for at least MIN_TIME
+function time(parse) {
+    let iterations = 0
+    let elapsed = 0
+    while (elapsed < MIN_TIME && iterations < MAX_ITERATIONS) {
+        const start = process.hrtime.bigint()
+        parse()
+        elapsed += seconds(start)
+        iterations++
+    }
+    return elapsed / iterations
+}
+
+async function main() {
+    const NativeParser = require('tree-sitter')
+    const { Parser, Language } = require('web-tree-sitter')
+
+    const bytes = fs.readFileSync(wasmPath)
+    const corpus = inputs()
+
+    let start = process.hrtime.bigint()
+    await Parser.init()
+    const init = seconds(start)
+    start = process.hrtime.bigint()
+    await WebAssembly.compile(bytes)
+    const compile = seconds(start)
+    start = process.hrtime.bigint()
+    const language = await Language.load(bytes)
+    const load = seconds(start)
+
+    const wasm = new Parser()
+    wasm.setLanguage(language)
+    const first = corpus[0]
+    start = process.hrtime.bigint()
+    if (first) wasm.parse(first.source).delete()
+    const cold = seconds(start)
+
+    console.log(`module           ${path.relative(root, wasmPath)}, ${(bytes.length / 1024).toFixed(1)} KiB`)
+    console.log(`Parser.init      ${(init * 1e3).toFixed(2)} ms`)
+    console.log(`compile          ${(compile * 1e3).toFixed(2)} ms`)
+    console.log(`Language.load    ${(load * 1e3).toFixed(2)} ms`)
+    if (first) console.log(`first parse      ${(cold * 1e3).toFixed(2)} ms (${first.name})`)
+    console.log()
+
+    const native = new NativeParser()
+    native.setLanguage(require(root))
+
+    console.log(`${'input'.padEnd(32)} ${'bytes'.padStart(10)} ${'native MB/s'.padStart(12)} ${'wasm MB/s'.padStart(10)} ${'ratio'.padStart(7)}`)
+    for (const input of corpus) {
+        const nativeTime = time(() => native.parse(input.source))
+        const wasmTime = time(() => wasm.parse(input.source).delete())
+        const mb = input.source.length / 1e6
+        console.log(
+            `${input.name.padEnd(32)} ${String(input.source.length).padStart(10)} ` +
+            `${(mb / nativeTime).toFixed(2).padStart(12)} ${(mb / wasmTime).toFixed(2).padStart(10)} ` +
+            `${(wasmTime / nativeTime).toFixed(2).padStart(6)}x`,
+        )
+    }
+}
+
+main().catch(error => {
+    console.error(error)
+    process.exit(1)
+})
@@ -0,0 +1,103 @@
+#!/usr/bin/env node
+/**
+ * Optimized WASM build of the parsers.
+ *
+ *   node script/build-wasm.js                 # tree-sitter-jass.wasm, tuned for speed
+ *   node script/build-wasm.js --size          # tuned for size (-Oz)
+ *   node script/build-wasm.js --no-simd       # for engines without 128-bit SIMD
+ *   node script/build-wasm.js --all           # every grammar in tree-sitter.json
+ *
+ * `tree-sitter build --wasm` compiles with fixed flags. This compiles
+ * src/parser.c and src/scanner.c with emcc directly, and the `prestart`
+ * script and generate.sh run it to build the playground's module too:
+ * -O3 (or -Oz), -msimd128 so clang may vectorize, no exceptions, hidden
+ * visibility and no debug info, as the same side module web-tree-sitter
+ * loads. If binaryen's wasm-opt is on PATH the module is optimized again
+ * and stripped of names and producers. Brotli and gzip copies
+ * (`.wasm.br`, `.wasm.gz`) are written next to it for servers that send
+ * precompressed files. Without emcc the module comes from
+ * `tree-sitter build --wasm` and is only post-processed.
+ */
+
+const { execFileSync, spawnSync } = require('child_process')
+const fs = require('fs')
+const path = require('path')
+const zlib = require('zlib')
+
+const root = path.join(__dirname, '..')
+const config = require(path.join(root, 'tree-sitter.json'))
+const args = process.argv.slice(2)
+const size = args.includes('--size')
+const simd = !args.includes('--no-simd')
+const grammars = args.includes('--all') ? config.grammars : config.grammars.slice(0, 1)
+
+function available(command) {
+    return spawnSync(command, ['--version'], { stdio: 'ignore' }).status === 0
+}
+
+function run(command, commandArgs, cwd = root) {
+    console.error(`$ ${command} ${commandArgs.join(' ')}`)
+    execFileSync(command, commandArgs, { cwd, stdio: 'inherit' })
+}
+
+function kib(bytes) {
+    return `${(bytes / 1024).toFixed(1)} KiB`
+}
+
+const emcc = available('emcc')
+const wasmOpt = available('wasm-opt')
+
+for (const grammar of grammars) {
+    const dir = path.join(root, grammar.path || '.')
+    const output = path.join(root, `tree-sitter-${grammar.name}.wasm`)
+    const sources = ['src/parser.c', 'src/scanner.c'].map(file => path.join(dir, file))
+
+    if (emcc) {
+        run('emcc', [
+            size ? '-Oz' : '-O3',
+            ...(simd ? ['-msimd128'] : []),
+            '-g0',
+            '-fno-exceptions',
+            '-fvisibility=hidden',
+            '-s', 'WASM=1',
+            '-s', 'SIDE_MODULE=2',
+            '-s', `EXPORTED_FUNCTIONS=["_tree_sitter_${grammar.name}"]`,
+            '-I', path.join(dir, 'src'),
+            ...sources,
+            '-o', output,
+        ])
+    } else {
+        console.error('emcc not found; building with tree-sitter build --wasm')
+        run('tree-sitter', ['build', '--wasm', '--output', output], dir)
+    }
+    const built = fs.statSync(output).size
+
+    if (wasmOpt) {
+        run('wasm-opt', [
+            size ? '-Oz' : '-O3',
+            ...(simd ? ['--enable-simd'] : []),
+            '--strip-debug',
+            '--strip-producers',
+            output,
+            '-o', output,
+        ])
+    } else {
+        console.error('wasm-opt not found; skipping the binaryen pass')
+    }
+
+    const module = fs.readFileSync(output)
+    const brotli = zlib.brotliCompressSync(module, {
+        params: {
+            [zlib.constants.BROTLI_PARAM_QUALITY]: zlib.constants.BROTLI_MAX_QUALITY,
+            [zlib.constants.BROTLI_PARAM_SIZE_HINT]: module.length,
+        },
+    })
+    const gzip = zlib.gzipSync(module, { level: zlib.constants.Z_BEST_COMPRESSION })
+    fs.writeFileSync(`${output}.br`, brotli)
+    fs.writeFileSync(`${output}.gz`, gzip)
+
+    console.log(
+        `${path.basename(output)}: ${kib(built)} built, ${kib(module.length)} final, ` +
+        `${kib(gzip.length)} gzip, ${kib(brotli.length)} brotli`,
+    )
+}
@@ -0,0 +1,185 @@
+#!/usr/bin/env node
+/**
+ * Generates the node kind and field id tables of both bindings from
+ * src/parser.c:
+ *   bindings/rust/ids.rs  `kind::FUNCTION_STATEMENT`, `field::NAME`
+ *   bindings/node/ids.js  `kinds.function_statement`, `fields.name`
+ *
+ * Tree walkers can then dispatch on `kind_id()` / `typeId` instead of
+ * comparing kind strings. Only named, visible node kinds are listed; ids are
+ * the public ones a node reports (after ts_symbol_map). Both bindings check
+ * the tables against the loaded language (Rust: unit test, Node: at load).
+ *
+ * The external tokens of every generated parser are also compared with the
+ * TokenType enum of common/scanner.h, which the scanner numbers its tokens
+ * by. Both modes fail on a mismatch: the parser is then older or newer than
+ * the scanner, and so are the tables.
+ *
+ * Run after `tree-sitter generate`:
+ *   node script/generate-ids.js          write both tables
+ *   node script/generate-ids.js --check  fail if either table is stale
+ */
+
+const fs = require('fs')
+const path = require('path')
+
+const root = path.join(__dirname, '..')
+const parserPath = path.join(root, 'src', 'parser.c')
+const rustPath = path.join(root, 'bindings', 'rust', 'ids.rs')
+const nodePath = path.join(root, 'bindings', 'node', 'ids.js')
+
+// Body of `<head> { ... };` in the generated parser
+function block(source, head) {
+    const start = source.indexOf(head)
+    if (start < 0) throw new Error(`src/parser.c: missing ${head}`)
+    return source.slice(source.indexOf('{', start) + 1, source.indexOf('\n};', start))
+}
+
+function enumValues(source, name) {
+    const values = new Map([['ts_builtin_sym_end', 0]])
+    for (const [, id, value] of block(source, `enum ${name}`).matchAll(/(\w+) = (\d+),/g)) {
+        values.set(id, Number(value))
+    }
+    return values
+}
+
+function readLanguage(source) {
+    const symbols = enumValues(source, 'ts_symbol_identifiers')
+    const names = new Map()
+    for (const [, id, name] of block(source, 'ts_symbol_names[]').matchAll(/\[(\w+)\] = "((?:[^"\\]|\\.)*)"/g)) {
+        names.set(id, name)
+    }
+    const map = new Map()
+    for (const [, id, target] of block(source, 'ts_symbol_map[]').matchAll(/\[(\w+)\] = (\w+),/g)) {
+        map.set(id, target)
+    }
+    const metadata = new Map()
+    for (const [, id, visible, named] of block(source, 'ts_symbol_metadata[]')
+        .matchAll(/\[(\w+)\] = \{\s*\.visible = (\w+),\s*\.named = (\w+),/g)) {
+        metadata.set(id, { visible: visible === 'true', named: named === 'true' })
+    }
+
+    const kinds = new Map()
+    for (const [id, value] of symbols) {
+        const meta = metadata.get(id)
+        if (!meta || !meta.visible || !meta.named || map.get(id) !== id) continue
+        const name = names.get(id)
+        if (!kinds.has(name)) kinds.set(name, value)
+    }
+
+    const fields = new Map()
+    for (const [id, value] of enumValues(source, 'ts_field_identifiers')) {
+        if (id.startsWith('field_')) fields.set(id.slice('field_'.length), value)
+    }
+
+    const byName = (a, b) => a[0] < b[0] ? -1 : a[0] > b[0] ? 1 : 0
+    return { kinds: [...kinds].sort(byName), fields: [...fields].sort(byName) }
+}
+
+const constName = name => name.toUpperCase()
+
+function renderRust({ kinds, fields }) {
+    const lines = []
+    const out = line => lines.push(line)
+    out('// Generated by script/generate-ids.js from src/parser.c.')
+    out('// Do not edit: run `node script/generate-ids.js` after `tree-sitter generate`.')
+    out('')
+    out('/// Node kind ids of the named node types, as returned by `Node::kind_id()`.')
+    out('pub mod kind {')
+    for (const [name, id] of kinds) out(`    pub const ${constName(name)}: u16 = ${id};`)
+    out('}')
+    out('')
+    out('/// Field ids, as taken by `Node::child_by_field_id()` and returned by')
+    out('/// `TreeCursor::field_id()`.')
+    out('pub mod field {')
+    for (const [name, id] of fields) out(`    pub const ${constName(name)}: u16 = ${id};`)
+    out('}')
+    out('')
+    out('/// Every `kind` constant with its node kind name.')
+    out('pub const KINDS: &[(&str, u16)] = &[')
+    for (const [name, id] of kinds) out(`    ("${name}", ${id}),`)
+    out('];')
+    out('')
+    out('/// Every `field` constant with its field name.')
+    out('pub const FIELDS: &[(&str, u16)] = &[')
+    for (const [name, id] of fields) out(`    ("${name}", ${id}),`)
+    out('];')
+    return lines.join('\n') + '\n'
+}
+
+function renderNode({ kinds, fields }) {
+    const lines = []
+    const out = line => lines.push(line)
+    out('// Generated by script/generate-ids.js from src/parser.c.')
+    out('// Do not edit: run `node script/generate-ids.js` after `tree-sitter generate`.')
+    out('')
+    out('// Node kind ids of the named node types (`node.typeId`).')
+    out('exports.kinds = Object.freeze({')
+    for (const [name, id] of kinds) out(`  ${name}: ${id},`)
+    out('});')
+    out('')
+    out('// Field ids (`cursor.currentFieldId`).')
+    out('exports.fields = Object.freeze({')
+    for (const [name, id] of fields) out(`  ${name}: ${id},`)
+    out('});')
+    return lines.join('\n') + '\n'
+}
+
+// External token names of a generated parser, `_id_token` -> `ID_TOKEN`
+function parserExternals(source) {
+    return [...enumValues(source, 'ts_external_scanner_symbol_identifiers')]
+        .filter(([id]) => id.startsWith('ts_external_token_'))
+        .sort((a, b) => a[1] - b[1])
+        .map(([id]) => id.slice('ts_external_token_'.length).replace(/^_/, '').toUpperCase())
+}
+
+// TokenType of common/scanner.h as compiled with `defines`
+function scannerTokens(defines) {
+    const source = fs.readFileSync(path.join(root, 'common', 'scanner.h'), 'utf8')
+    const tokens = []
+    const active = []
+    for (const line of block(source, 'enum TokenType').split('\n')) {
+        const ifdef = line.match(/^#ifdef (\w+)/)
+        if (ifdef) active.push(defines.has(ifdef[1]))
+        else if (line.startsWith('#endif')) active.pop()
+        else if (active.every(Boolean)) {
+            const token = line.match(/^\s*(\w+),/)
+            if (token && token[1] !== 'TOKEN_TYPE_COUNT') tokens.push(token[1])
+        }
+    }
+    return tokens
+}
+
+for (const grammar of require(path.join(root, 'tree-sitter.json')).grammars) {
+    const dir = path.join(root, grammar.path || '.', 'src')
+    const parser = path.join(dir, 'parser.c')
+    if (!fs.existsSync(parser)) continue
+    const scanner = fs.readFileSync(path.join(dir, 'scanner.c'), 'utf8')
+    const defines = new Set([...scanner.matchAll(/^#define (JASS_\w+)/gm)].map(match => match[1]))
+    const externals = parserExternals(fs.readFileSync(parser, 'utf8'))
+    const tokens = scannerTokens(defines)
+    if (externals.join() !== tokens.join()) {
+        console.error(`${path.relative(root, parser)}: externals ${externals.join(', ')}`)
+        console.error(`common/scanner.h: TokenType ${tokens.join(', ')}`)
+        console.error('the parser and the scanner disagree: run `tree-sitter generate`')
+        process.exit(1)
+    }
+}
+
+const language = readLanguage(fs.readFileSync(parserPath, 'utf8'))
+const outputs = [
+    [rustPath, renderRust(language)],
+    [nodePath, renderNode(language)],
+]
+
+if (process.argv.includes('--check')) {
+    for (const [file, content] of outputs) {
+        const current = fs.existsSync(file) ? fs.readFileSync(file, 'utf8') : ''
+        if (current !== content) {
+            console.error(`${path.relative(root, file)} is out of date: run \`node script/generate-ids.js\``)
+            process.exit(1)
+        }
+    }
+} else {
+    for (const [file, content] of outputs) fs.writeFileSync(file, content)
+}
@@ -0,0 +1,120 @@
+#!/usr/bin/env node
+/**
+ * Generates common/keywords.h from src/grammar.json.
+ *
+ * The external scanner has to reject keywords when it scans identifiers,
+ * so it needs the grammar's keyword list. Instead of a hand-kept copy this
+ * script collects every word-like string literal of the grammar (string
+ * literals inside token() rules, like the `_` number separator, are not
+ * keywords) and emits a recognizer bucketed by length and then by one
+ * distinguishing character, so a lookup costs at most one memcmp.
+ *
+ * Run after `tree-sitter generate`:
+ *   node script/generate-keywords.js          write common/keywords.h
+ *   node script/generate-keywords.js --check  fail if common/keywords.h is stale
+ */
+
+const fs = require('fs')
+const path = require('path')
+
+const root = path.join(__dirname, '..')
+const grammarPath = path.join(root, 'src', 'grammar.json')
+const outputPath = path.join(root, 'common', 'keywords.h')
+
+function collectKeywords(grammar) {
+    const keywords = new Set()
+    const walk = rule => {
+        if (!rule || typeof rule !== 'object') return
+        if (rule.type === 'TOKEN' || rule.type === 'IMMEDIATE_TOKEN') return
+        if (rule.type === 'STRING' && /^[A-Za-z_][A-Za-z0-9_]*$/.test(rule.value)) {
+            keywords.add(rule.value)
+            return
+        }
+        for (const value of Object.values(rule)) walk(value)
+    }
+    for (const rule of Object.values(grammar.rules)) walk(rule)
+    return [...keywords].sort()
+}
+
+// Index at which every keyword of the bucket has a different character
+function discriminator(bucket) {
+    for (let i = 0; i < bucket[0].length; i++) {
+        if (new Set(bucket.map(kw => kw[i])).size === bucket.length) return i
+    }
+    return -1
+}
+
+const charLiteral = c => `'${c}'`
+const enumName = kw => `KW_${kw.toUpperCase()}`
+
+function render(keywords) {
+    const buckets = new Map()
+    for (const kw of keywords) {
+        if (!buckets.has(kw.length)) buckets.set(kw.length, [])
+        buckets.get(kw.length).push(kw)
+    }
+    const maxLen = Math.max(...keywords.map(kw => kw.length))
+
+    const lines = []
+    const out = line => lines.push(line)
+
+    out('// Generated by script/generate-keywords.js from src/grammar.json.')
+    out('// Do not edit: run `node script/generate-keywords.js` after `tree-sitter generate`.')
+    out('')
+    out('#ifndef TREE_SITTER_JASS_KEYWORDS_H_')
+    out('#define TREE_SITTER_JASS_KEYWORDS_H_')
+    out('')
+    out('#include <stddef.h>')
+    out('#include <string.h>')
+    out('')
+    out('typedef enum {')
+    out('    KW_NONE,')
+    for (const kw of keywords) out(`    ${enumName(kw)},`)
+    out('} Keyword;')
+    out('')
+    out(`#define KEYWORD_COUNT ${keywords.length}`)
+    out(`#define KEYWORD_MAX_LEN ${maxLen}`)
+    out('')
+    out('// Returns the keyword spelled by word[0..len), or KW_NONE for identifiers.')
+    out('static inline Keyword keyword_lookup(const char *word, size_t len) {')
+    out('    switch (len) {')
+    for (const len of [...buckets.keys()].sort((a, b) => a - b)) {
+        const bucket = buckets.get(len)
+        out(`        case ${len}:`)
+        const at = discriminator(bucket)
+        if (at < 0) {
+            // No single distinguishing character: compare each candidate
+            for (const kw of bucket) {
+                out(`            if (memcmp(word, "${kw}", ${len}) == 0) return ${enumName(kw)};`)
+            }
+            out('            return KW_NONE;')
+            continue
+        }
+        out(`            switch (word[${at}]) {`)
+        for (const kw of bucket) {
+            out(`                case ${charLiteral(kw[at])}: return memcmp(word, "${kw}", ${len}) == 0 ? ${enumName(kw)} : KW_NONE;`)
+        }
+        out('                default: return KW_NONE;')
+        out('            }')
+    }
+    out('        default:')
+    out('            return KW_NONE;')
+    out('    }')
+    out('}')
+    out('')
+    out('#endif  // TREE_SITTER_JASS_KEYWORDS_H_')
+    return lines.join('\n') + '\n'
+}
+
+const grammar = JSON.parse(fs.readFileSync(grammarPath, 'utf8'))
+const header = render(collectKeywords(grammar))
+
+if (process.argv.includes('--check')) {
+    const current = fs.existsSync(outputPath) ? fs.readFileSync(outputPath, 'utf8') : ''
+    if (current !== header) {
+        console.error('common/keywords.h is out of date: run `node script/generate-keywords.js`')
+        process.exit(1)
+    }
+} else {
+    fs.writeFileSync(outputPath, header)
+}
@@ -0,0 +1,23 @@
+#!/usr/bin/env node
+/**
+ * Regenerates every grammar listed in tree-sitter.json, then the files
+ * derived from them (common/keywords.h, the binding id tables).
+ *
+ *   node script/generate.js
+ */
+
+const { execFileSync } = require('child_process')
+const path = require('path')
+
+const root = path.join(__dirname, '..')
+const config = require(path.join(root, 'tree-sitter.json'))
+
+for (const grammar of config.grammars) {
+    const cwd = path.join(root, grammar.path || '.')
+    console.log(`tree-sitter generate (${grammar.name})`)
+    execFileSync('tree-sitter', ['generate'], { cwd, stdio: 'inherit' })
+}
+
+for (const script of ['generate-keywords.js', 'generate-ids.js']) {
+    execFileSync(process.execPath, [path.join(__dirname, script)], { stdio: 'inherit' })
+}
@@ -0,0 +1,144 @@
+#!/usr/bin/env node
+/**
+ * Profile-guided build pipeline for the native parsers.
+ *
+ *   node script/pgo.js rust [--dir target/pgo]
+ *   node script/pgo.js node [--dir build-pgo]
+ *
+ * Both modes measure three builds of the same parser.c and scanner.c on the
+ * same inputs and print the throughput of each:
+ *
+ *   default    the plain build
+ *   optimized  -O3 and LTO (JASS_OPTIMIZE / npm_config_jass_optimize)
+ *   pgo        optimized, plus the profile of an instrumented training run
+ *
+ * rust trains and measures with `cargo bench --bench parse`, i.e. on the
+ * examples, the generated maps and $JASS_BENCH_CORPUS. node needs the
+ * `tree-sitter` package installed (for exportFlat) and runs exportFlat over
+ * the examples and $JASS_BENCH_CORPUS. With clang (CC=clang, or macOS for
+ * node), llvm-profdata merges the raw profiles.
+ */
+
+const { execFileSync } = require('child_process')
+const fs = require('fs')
+const path = require('path')
+
+const root = path.join(__dirname, '..')
+const mode = process.argv[2]
+const dirFlag = process.argv.indexOf('--dir')
+const dir = path.resolve(root, dirFlag > 0 ? process.argv[dirFlag + 1] : mode === 'node' ? 'build-pgo' : 'target/pgo')
+const clang = /clang/.test(process.env.CC || '') || (mode === 'node' && process.platform === 'darwin')
+
+function run(command, args, env, capture = false) {
+    console.error(`$ ${command} ${args.join(' ')}`)
+    return execFileSync(command, args, {
+        cwd: root,
+        env: { ...process.env, ...env },
+        stdio: capture ? ['ignore', 'pipe', 'inherit'] : 'inherit',
+        encoding: 'utf8',
+        maxBuffer: 64 << 20,
+    })
+}
+
+function mergeProfiles() {
+    if (!clang) return
+    const raw = fs.readdirSync(dir).filter(name => name.endsWith('.profraw')).map(name => path.join(dir, name))
+    const profdata = process.platform === 'darwin' ? ['xcrun', ['llvm-profdata']] : ['llvm-profdata', []]
+    run(profdata[0], [...profdata[1], 'merge', '-o', path.join(dir, 'default.profdata'), ...raw])
+}
+
+// `cargo bench --bench parse` rows: grammar, input, bytes, iters, MB/s, ...
+function benchRows(output) {
+    const rows = new Map()
+    for (const line of output.split('\n').slice(1)) {
+        const columns = line.trim().split(/\s+/)
+        const mbPerS = Number(columns[4])
+        if (columns.length > 4 && Number.isFinite(mbPerS)) rows.set(`${columns[0]} ${columns[1]}`, mbPerS)
+    }
+    return rows
+}
+
+function rust() {
+    const bench = env => benchRows(run('cargo', ['bench', '--bench', 'parse'], env, true))
+    const optimize = { JASS_OPTIMIZE: '1' }
+    if (clang) {
+        optimize.JASS_LTO = '1'
+        optimize.RUSTFLAGS = `${process.env.RUSTFLAGS || ''} -Clinker-plugin-lto -Clinker=clang`.trim()
+    }
+
+    const results = { default: bench({}), optimized: bench(optimize) }
+    fs.rmSync(dir, { recursive: true, force: true })
+    fs.mkdirSync(dir, { recursive: true })
+    const generate = { ...optimize, JASS_PGO_GENERATE: dir }
+    if (clang) generate.RUSTFLAGS = `${optimize.RUSTFLAGS} -Cprofile-generate=${dir}`
+    bench(generate)
+    mergeProfiles()
+    results.pgo = bench({ ...optimize, JASS_PGO_USE: dir })
+    return results
+}
+
+// Runs exportFlat over every input for at least half a second each and
+// prints `name<TAB>MB/s` lines; `train` parses each input a few times only.
+const NODE_DRIVER = `
+const fs = require('fs'), path = require('path')
+const { exportFlat } = require(process.argv[1])
+const train = process.argv[2] === 'train'
+const files = [path.join(process.argv[1], 'examples/example.jass'), path.join(process.argv[1], 'examples/test.jass')]
+const walk = dir => { for (const e of fs.readdirSync(dir, { withFileTypes: true })) {
+    const p = path.join(dir, e.name)
+    if (e.isDirectory()) walk(p); else if (/\\.(j|jass)$/.test(e.name)) files.push(p)
+} }
+if (process.env.JASS_BENCH_CORPUS) walk(process.env.JASS_BENCH_CORPUS)
+for (const file of files) {
+    if (!fs.existsSync(file)) continue
+    const source = fs.readFileSync(file)
+    let iterations = 0, start = process.hrtime.bigint(), elapsed = 0
+    while (train ? iterations < 5 : elapsed < 0.5) {
+        exportFlat(source)
+        iterations++
+        elapsed = Number(process.hrtime.bigint() - start) / 1e9
+    }
+    if (!train) console.log(path.relative(process.argv[1], file) + '\\t' + (source.length * iterations / elapsed / 1e6).toFixed(2))
+}
+`
+
+function node() {
+    const rebuild = env => run('npx', ['node-gyp', 'rebuild'], env)
+    const measure = () => {
+        const rows = new Map()
+        for (const line of run(process.execPath, ['-e', NODE_DRIVER, root], {}, true).trim().split('\n')) {
+            const [name, mbPerS] = line.split('\t')
+            if (name) rows.set(name, Number(mbPerS))
+        }
+        return rows
+    }
+    const optimize = { npm_config_jass_optimize: '1' }
+
+    rebuild({})
+    const results = { default: measure() }
+    rebuild(optimize)
+    results.optimized = measure()
+    fs.rmSync(dir, { recursive: true, force: true })
+    fs.mkdirSync(dir, { recursive: true })
+    rebuild({ ...optimize, npm_config_jass_pgo: 'generate', npm_config_jass_pgo_dir: dir })
+    run(process.execPath, ['-e', NODE_DRIVER, root, 'train'], {})
+    mergeProfiles()
+    rebuild({ ...optimize, npm_config_jass_pgo: 'use', npm_config_jass_pgo_dir: dir })
+    results.pgo = measure()
+    return results
+}
+
+if (mode !== 'rust' && mode !== 'node') {
+    console.error('usage: node script/pgo.js rust|node [--dir <profile directory>]')
+    process.exit(2)
+}
+const results = mode === 'rust' ? rust() : node()
+
+const width = Math.max(5, ...[...results.default.keys()].map(name => name.length))
+console.log(`${'input'.padEnd(width)} ${'default'.padStart(9)} ${'optimized'.padStart(9)} ${'pgo'.padStart(9)} ${'speedup'.padStart(8)}  (MB/s)`)
+for (const [name, base] of results.default) {
+    const optimized = results.optimized.get(name)
+    const pgo = results.pgo.get(name)
+    const speedup = pgo && base ? `${(pgo / base).toFixed(2)}x` : '-'
+    console.log(`${name.padEnd(width)} ${String(base).padStart(9)} ${String(optimized ?? '-').padStart(9)} ${String(pgo ?? '-').padStart(9)} ${speedup.padStart(8)}`)
+}